@@ -0,0 +1,416 @@
+#include "allocation_counter.h"
+#include "argparse/parser.h"
+#include "argparse/convert.h"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory_resource>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace argparse;
+
+// Microbenchmarks for the parser. Every workload is generated from fixed data,
+// so runs differ only in timing. Allocations are counted by the replacement
+// global operator new of the tests' allocation_counter.
+//
+// usage: argparse_bench [--csv file] [--json file] [--min-time ms] [--filter text]
+
+struct bench_result {
+    std::string name;
+    u64 size;
+    u64 iterations;
+    f64 ns_per_op;
+    f64 allocs_per_op;
+    f64 bytes_per_op;
+};
+
+static f64 min_time_ms = 200.0;
+static std::string filter;
+static std::vector<bench_result> results;
+
+// Keep the compiler from dropping a result
+static volatile u64 sink = 0;
+
+// Time op, doubling the iteration count until the run takes min_time_ms
+static void run(const std::string& name, u64 size, const std::function<void()>& op) {
+    if (!filter.empty() && name.find(filter) == std::string::npos) {
+        return;
+    }
+    op();  // warm up
+    u64 iterations = 1;
+    while (true) {
+        long long allocations_before = allocation_count();
+        long long bytes_before = allocated_bytes();
+        auto start = std::chrono::steady_clock::now();
+        for (u64 i = 0; i < iterations; i++) {
+            op();
+        }
+        std::chrono::duration<f64, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        if (elapsed.count() >= min_time_ms || iterations >= (1ull << 30)) {
+            bench_result result;
+            result.name = name;
+            result.size = size;
+            result.iterations = iterations;
+            result.ns_per_op = elapsed.count() * 1e6 / iterations;
+            result.allocs_per_op = (f64)(allocation_count() - allocations_before) / iterations;
+            result.bytes_per_op = (f64)(allocated_bytes() - bytes_before) / iterations;
+            results.push_back(result);
+            std::printf("%-28s %9llu %12.1f %10.2f %12.1f %10llu\n", name.c_str(), size, result.ns_per_op,
+                        result.allocs_per_op, result.bytes_per_op, iterations);
+            return;
+        }
+        iterations *= 2;
+    }
+}
+
+// Argument vector of count tokens cycling through options of the small spec
+static std::vector<std::string> make_tokens(u64 count) {
+    static const char* cycle[] = {"--number", "42", "-v", "-f", "input.txt", "--rate", "0.25"};
+    std::vector<std::string> tokens;
+    tokens.reserve(count);
+    tokens.push_back("bench");
+    for (u64 i = 1; i < count; i++) {
+        tokens.push_back(cycle[(i - 1) % 7]);
+    }
+    // never end on an option that is missing its value
+    while (tokens.size() > 1 && (tokens.back() == "--number" || tokens.back() == "-f" || tokens.back() == "--rate")) {
+        tokens.back() = "-v";
+    }
+    return tokens;
+}
+
+static void add_small_spec(parser& p) {
+    p.set_auto_help(false);
+    p.add_parameter("v", "verbose", "Enable verbose output", NONE);
+    p.add_parameter("n", "number", "Number of iterations", INTEGER, false, "1");
+    p.add_parameter("f", "file", "Input file path", STRING, false, "default.txt");
+    p.add_parameter("r", "rate", "Sampling rate", FLOAT, false, "0.5");
+}
+
+static std::vector<std::string> option_names(u64 count) {
+    std::vector<std::string> names;
+    for (u64 i = 0; i < count; i++) {
+        names.push_back("option-" + std::to_string(i));
+    }
+    return names;
+}
+
+static void add_options(parser& p, const std::vector<std::string>& names) {
+    p.set_auto_help(false);
+    for (const std::string& name : names) {
+        p.add_parameter("", name, "Generated option used for benchmarks", INTEGER, false, "7");
+    }
+}
+
+static void bench_parse() {
+    parser p;
+    add_small_spec(p);
+    p.freeze();
+    parse_result result;
+    for (u64 count = 10; count <= 1000000; count *= 10) {
+        std::vector<std::string> tokens = make_tokens(count);
+        std::vector<const char*> argv;
+        for (const std::string& token : tokens) {
+            argv.push_back(token.c_str());
+        }
+        run("parse_result", count, [&]() {
+            sink += p.parse((int)argv.size(), argv.data(), result);
+        });
+        run("parse_stateful", count, [&]() {
+            sink += p.parse(tokens);
+        });
+        std::string cmdline;
+        for (const std::string& token : tokens) {
+            cmdline += token;
+            cmdline += '\0';
+        }
+        run("parse_cmdline", count, [&]() {
+            sink += p.parse_cmdline(cmdline, result);
+        });
+    }
+    // one string value of 1 KB to 64 MB, which should cost time in proportion
+    for (u64 size = 1 << 10; size <= 1 << 26; size *= 16) {
+        std::string value(size, 'x');
+        const char* argv[] = {"prog", "-f", value.c_str()};
+        run("parse_long_value", size, [&]() {
+            sink += p.parse(3, argv, result);
+        });
+    }
+}
+
+// Decoding a list of ids in one argument, against splitting it and calling
+// std::stoll on each piece
+static void bench_lists() {
+    for (u64 count = 100; count <= 100000; count *= 10) {
+        std::string text;
+        for (u64 i = 0; i < count; i++) {
+            text += (i > 0 ? "," : "") + std::to_string(i * 104729);
+        }
+        std::pmr::vector<i64> values;
+        run("to_integers", count, [&]() {
+            values.clear();
+            convert::to_integers(text, ',', values);
+            sink += values.size();
+        });
+        run("split_stoll", count, [&]() {
+            std::vector<i64> split;
+            std::string piece;
+            for (char c : text) {
+                if (c == ',') {
+                    split.push_back(std::stoll(piece));
+                    piece.clear();
+                } else {
+                    piece += c;
+                }
+            }
+            split.push_back(std::stoll(piece));
+            sink += split.size();
+        });
+    }
+}
+
+// Parsing -DNAME=VALUE defines into a map option and looking every key up,
+// against copying them into an std::unordered_map
+static void bench_maps() {
+    for (u64 count = 10; count <= 10000; count *= 10) {
+        std::vector<std::string> args = {"bench"};
+        for (u64 i = 0; i < count; i++) {
+            args.push_back("-DFEATURE_" + std::to_string(i) + "=" + std::to_string(i));
+        }
+        std::vector<const char*> argv;
+        for (const std::string& arg : args) {
+            argv.push_back(arg.c_str());
+        }
+        parser p;
+        p.set_auto_help(false);
+        handle<string_map> defines = p.add_parameter<string_map>("D", "define", "Define a macro");
+        p.freeze();
+        parse_result result;
+        run("parse_defines", count, [&]() {
+            p.parse((int)argv.size(), argv.data(), result);
+            string_map macros = result.get(defines);
+            for (u64 i = 1; i < args.size(); i++) {
+                sink += macros.find(std::string_view(args[i]).substr(2, args[i].find('=') - 2)) != nullptr;
+            }
+        });
+        run("unordered_map_defines", count, [&]() {
+            std::unordered_map<std::string, std::string> macros;
+            for (u64 i = 1; i < args.size(); i++) {
+                u64 equals = args[i].find('=');
+                macros[args[i].substr(2, equals - 2)] = args[i].substr(equals + 1);
+            }
+            for (u64 i = 1; i < args.size(); i++) {
+                sink += macros.count(args[i].substr(2, args[i].find('=') - 2));
+            }
+        });
+    }
+}
+
+// Registering and parsing feature toggles as one flag family, against one
+// flag option per toggle
+static void bench_flags() {
+    for (u64 count = 20; count <= 2000; count *= 10) {
+        std::vector<std::string> names;
+        std::vector<std::string> args = {"bench"};
+        for (u64 i = 0; i < count; i++) {
+            names.push_back("feature-" + std::to_string(i));
+            if (i % 10 == 0) {
+                args.push_back("-f" + names.back());
+            }
+        }
+        std::vector<const char*> argv;
+        for (const std::string& arg : args) {
+            argv.push_back(arg.c_str());
+        }
+        run("register_flag_family", count, [&]() {
+            parser p;
+            handle<flag_set> features = p.add_flag_family("feature", "-f", "-fno-", "Features");
+            for (const std::string& name : names) {
+                p.add_flag(features, name);
+            }
+            sink += features.get_id();
+        });
+        run("register_flag_options", count, [&]() {
+            parser p;
+            for (const std::string& name : names) {
+                p.add_parameter<bool>("f" + name, "", "Feature");
+            }
+        });
+
+        parser family;
+        family.set_auto_help(false);
+        handle<flag_set> features = family.add_flag_family("feature", "-f", "-fno-", "Features");
+        for (const std::string& name : names) {
+            family.add_flag(features, name);
+        }
+        family.freeze();
+        parser options;
+        options.set_auto_help(false);
+        for (const std::string& name : names) {
+            options.add_parameter<bool>("f" + name, "", "Feature");
+        }
+        options.freeze();
+        parse_result result;
+        run("parse_flag_family", count, [&]() {
+            sink += family.parse((int)argv.size(), argv.data(), result);
+        });
+        run("parse_flag_options", count, [&]() {
+            sink += options.parse((int)argv.size(), argv.data(), result);
+        });
+    }
+}
+
+static void bench_lookup() {
+    for (u64 count = 10; count <= 10000; count *= 10) {
+        std::vector<std::string> names = option_names(count);
+        parser p;
+        add_options(p, names);
+        p.freeze();
+        std::vector<std::string> flags;
+        for (u64 i = 0; i < count; i++) {
+            flags.push_back("--" + names[(i * 7919) % count]);
+        }
+        u64 next = 0;
+        run("lookup_long_name", count, [&]() {
+            i64 value = 0;
+            p.get_parameter_value_to(flags[next], &value);
+            next = next + 1 == count ? 0 : next + 1;
+            sink += value;
+        });
+        parse_result result;
+        const char* argv[] = {"bench", flags[count / 2].c_str(), "3"};
+        run("parse_one_of_many", count, [&]() {
+            sink += p.parse(3, argv, result);
+        });
+    }
+}
+
+static void bench_help() {
+    for (u64 count = 10; count <= 1000; count *= 10) {
+        std::vector<std::string> names = option_names(count);
+        parser p;
+        add_options(p, names);
+        run("get_help_message", count, [&]() {
+            sink += p.get_help_message().size();
+        });
+    }
+}
+
+static void bench_value_to() {
+    parser p;
+    add_small_spec(p);
+    std::vector<std::string> tokens = {"bench", "-n", "5", "-f", "data.csv", "-v"};
+    p.parse(tokens);
+    bool flag = false;
+    i64 integer = 0;
+    f64 real = 0.0;
+    std::string text;
+    run("value_to_bool", 1, [&]() {
+        p.get_parameter_value_to("verbose", &flag);
+        sink += flag;
+    });
+    run("value_to_integer", 1, [&]() {
+        p.get_parameter_value_to("-n", &integer);
+        sink += integer;
+    });
+    run("value_to_float", 1, [&]() {
+        p.get_parameter_value_to("--rate", &real);
+        sink += (u64)real;
+    });
+    run("value_to_string", 1, [&]() {
+        p.get_parameter_value_to("file", &text);
+        sink += text.size();
+    });
+}
+
+static void bench_construction() {
+    for (u64 count = 1; count <= 100; count *= 10) {
+        std::vector<std::string> names = option_names(count);
+        run("construct_destroy", count, [&]() {
+            parser p;
+            add_options(p, names);
+        });
+        std::vector<char> buffer(1 << 20);
+        run("construct_destroy_arena", count, [&]() {
+            std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size());
+            parser p(&arena);
+            add_options(p, names);
+        });
+    }
+}
+
+static void write_csv(const std::string& path) {
+    std::ofstream out(path);
+    out << "name,size,iterations,ns_per_op,allocs_per_op,bytes_per_op\n";
+    for (const bench_result& r : results) {
+        out << r.name << "," << r.size << "," << r.iterations << "," << r.ns_per_op << ","
+            << r.allocs_per_op << "," << r.bytes_per_op << "\n";
+    }
+}
+
+static void write_json(const std::string& path) {
+    std::ofstream out(path);
+    out << "{\n  \"benchmarks\": [\n";
+    for (u64 i = 0; i < results.size(); i++) {
+        const bench_result& r = results[i];
+        out << "    {\"name\": \"" << r.name << "\", \"size\": " << r.size << ", \"iterations\": " << r.iterations
+            << ", \"ns_per_op\": " << r.ns_per_op << ", \"allocs_per_op\": " << r.allocs_per_op
+            << ", \"bytes_per_op\": " << r.bytes_per_op << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+static int usage_error(const std::string& message) {
+    std::cerr << "error: " << message << std::endl;
+    std::cerr << "usage: argparse_bench [--csv file] [--json file] [--min-time ms] [--filter text]" << std::endl;
+    return 2;
+}
+
+int main(int argc, char** argv) {
+    std::string csv_path;
+    std::string json_path;
+    // every flag takes a value
+    for (int i = 1; i < argc; i += 2) {
+        std::string flag = argv[i];
+        if (flag != "--csv" && flag != "--json" && flag != "--min-time" && flag != "--filter") {
+            return usage_error("unknown argument " + flag);
+        }
+        if (i + 1 >= argc) {
+            return usage_error(flag + " requires a value");
+        }
+        std::string value = argv[i + 1];
+        if (flag == "--csv") {
+            csv_path = value;
+        } else if (flag == "--json") {
+            json_path = value;
+        } else if (flag == "--min-time") {
+            if (convert::to_float(value, min_time_ms) != CONVERT_OK || !(min_time_ms > 0.0)) {
+                return usage_error("invalid value " + value + " for --min-time");
+            }
+        } else {
+            filter = value;
+        }
+    }
+
+    std::printf("%-28s %9s %12s %10s %12s %10s\n", "benchmark", "size", "ns/op", "allocs/op", "bytes/op", "iterations");
+    bench_parse();
+    bench_lists();
+    bench_maps();
+    bench_flags();
+    bench_lookup();
+    bench_help();
+    bench_value_to();
+    bench_construction();
+
+    if (!csv_path.empty()) {
+        write_csv(csv_path);
+    }
+    if (!json_path.empty()) {
+        write_json(json_path);
+    }
+    return 0;
+}
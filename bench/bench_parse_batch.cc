@@ -0,0 +1,71 @@
+#include "argparse/parser.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace argparse;
+
+// Measures parse_batch throughput and speedup over one thread
+// usage: bench_parse_batch [rows] [repeats]
+int main(int argc, char** argv) {
+    u64 rows = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200000;
+    int repeats = argc > 2 ? std::atoi(argv[2]) : 5;
+    
+    parser spec;
+    spec.add_parameter<i64>("n", "number", "A number", false, "0");
+    spec.add_parameter<f64>("r", "rate", "A rate", false, "1.0");
+    spec.add_parameter<std::string>("f", "file", "Input file", false, "none");
+    spec.add_parameter<bool>("v", "verbose", "Verbose mode");
+    spec.add_parameter<bool>("q", "quiet", "Quiet mode");
+    
+    // synthetic command lines, 8 tokens each
+    std::vector<std::string> strings;
+    strings.reserve(rows * 8);
+    std::vector<const char*> pointers;
+    pointers.reserve(rows * 8);
+    std::vector<arg_vector> inputs;
+    inputs.reserve(rows);
+    for (u64 i = 0; i < rows; i++) {
+        size_t first = pointers.size();
+        for (std::string token : {std::string("tool"), std::string("--number"), std::to_string(i),
+                                  std::string("-r"), std::to_string(i % 100) + ".25",
+                                  std::string("--file"), "input" + std::to_string(i) + ".txt",
+                                  std::string(i % 2 ? "-v" : "-q")}) {
+            strings.push_back(std::move(token));
+            pointers.push_back(strings.back().c_str());
+        }
+        inputs.push_back(arg_vector{8, pointers.data() + first});
+    }
+    
+    u32 hardware = std::thread::hardware_concurrency();
+    if (hardware == 0) {
+        hardware = 1;
+    }
+    
+    std::cout << "rows=" << rows << " hardware_threads=" << hardware << std::endl;
+    std::cout << "threads\trows_per_sec\tspeedup" << std::endl;
+    
+    batch_result results;
+    f64 baseline = 0.0;
+    for (u32 threads = 1; threads <= hardware * 2; threads *= 2) {
+        f64 best = 0.0;
+        for (int r = 0; r < repeats; r++) {
+            auto start = std::chrono::steady_clock::now();
+            spec.parse_batch(inputs, results, threads);
+            std::chrono::duration<f64> elapsed = std::chrono::steady_clock::now() - start;
+            f64 rate = rows / elapsed.count();
+            if (rate > best) {
+                best = rate;
+            }
+        }
+        if (threads == 1) {
+            baseline = best;
+        }
+        std::cout << threads << "\t" << (u64)best << "\t" << best / baseline << std::endl;
+    }
+    
+    return results.get_failure_count() == 0 ? 0 : 1;
+}
@@ -0,0 +1,73 @@
+#ifndef ARGPARSE_BATCH_H
+#define ARGPARSE_BATCH_H
+
+#include "argparse/defs.h"
+#include "argparse/handle.h"
+#include "argparse/span.h"
+
+namespace argparse
+{
+    // One command line of a batch, laid out like the arguments of main
+    struct arg_vector
+    {
+        int argc;
+        const char* const* argv;
+    };
+
+    // Results of parser::parse_batch in columnar form: one row per command line
+    // and one contiguous array per option. String values point into the parsed
+    // command lines, which must outlive the result.
+    class batch_result
+    {
+    public:
+        batch_result();
+
+        u64 size() const;
+        u64 get_failure_count() const;
+        bool succeeded(u64 row) const;
+        // Error message of a failed row, empty for rows that parsed
+        std::string_view get_error(u64 row) const;
+
+        // Value of an option in every row, or its default where it was not
+        // given or the row failed
+        template<typename T>
+        span<const typename parameter_traits<T>::column_type> column(handle<T> h) const
+        {
+            return column_values(h.get_id(), (typename parameter_traits<T>::column_type*)nullptr);
+        }
+
+        // Per row, 1 where the option was given
+        template<typename T>
+        span<const u8> is_set(handle<T> h) const
+        {
+            return this->columns[h.get_id()].present;
+        }
+
+    private:
+        friend class parser;
+
+        struct column_data
+        {
+            std::vector<u8> flags;
+            std::vector<i64> integers;
+            std::vector<f64> reals;
+            std::vector<std::string_view> texts;
+            std::vector<u8> present;
+        };
+
+        span<const u8> column_values(i32 id, u8*) const;
+        span<const i64> column_values(i32 id, i64*) const;
+        span<const f64> column_values(i32 id, f64*) const;
+        span<const std::string_view> column_values(i32 id, std::string_view*) const;
+
+        std::vector<column_data> columns;
+        std::vector<u8> row_succeeded;
+
+        // failed rows in ascending order, with their messages packed into one buffer
+        std::vector<u64> error_rows;
+        std::vector<u64> error_offsets;
+        std::string error_text;
+    };
+}
+
+#endif
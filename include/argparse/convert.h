@@ -0,0 +1,87 @@
+#ifndef ARGPARSE_CONVERT_H
+#define ARGPARSE_CONVERT_H
+
+#include "argparse/defs.h"
+#include <charconv>
+#include <limits>
+#include <type_traits>
+
+namespace argparse
+{
+    enum convert_status
+    {
+        CONVERT_OK, CONVERT_INVALID, CONVERT_OUT_OF_RANGE
+    };
+
+    // Locale independent text to number conversion built on std::from_chars.
+    // The whole text must be consumed, errors are reported through the returned
+    // status and never by throwing, and the output is only written on success.
+    class convert
+    {
+    public:
+        // base 0 detects the base from a 0x (hexadecimal) or 0 (octal) prefix,
+        // base 16 accepts an optional 0x prefix
+        template<typename T>
+        static convert_status to_integer(std::string_view text, T& value, int base = 10)
+        {
+            static_assert(std::is_integral<T>::value, "to_integer requires an integral type");
+            bool negative = false;
+            if (!text.empty() && (text[0] == '+' || text[0] == '-'))
+            {
+                negative = text[0] == '-';
+                text.remove_prefix(1);
+            }
+            base = strip_base_prefix(text, base);
+            // the sign was taken off above so "--5" and "+-5" are rejected
+            if (base < 2 || base > 36 || text.empty() || text[0] == '+' || text[0] == '-')
+            {
+                return CONVERT_INVALID;
+            }
+
+            typedef typename std::make_unsigned<T>::type magnitude_type;
+            magnitude_type magnitude = 0;
+            auto result = std::from_chars(text.data(), text.data() + text.size(), magnitude, base);
+            if (result.ec == std::errc::invalid_argument || result.ptr != text.data() + text.size())
+            {
+                return CONVERT_INVALID;
+            }
+            if (result.ec == std::errc::result_out_of_range)
+            {
+                return CONVERT_OUT_OF_RANGE;
+            }
+
+            if (std::is_signed<T>::value)
+            {
+                magnitude_type limit = (magnitude_type)std::numeric_limits<T>::max();
+                if (magnitude > limit + (negative ? 1 : 0))
+                {
+                    return CONVERT_OUT_OF_RANGE;
+                }
+            }
+            else if (negative && magnitude != 0)
+            {
+                return CONVERT_OUT_OF_RANGE;
+            }
+            value = negative ? (T)(0 - magnitude) : (T)magnitude;
+            return CONVERT_OK;
+        }
+
+        static convert_status to_float(std::string_view text, f64& value);
+        static convert_status to_float(std::string_view text, f32& value);
+
+        // Convert a list such as "1,2,3", appending its numbers to values.
+        // Separators are found 16 or 32 bytes at a time with SSE2 or AVX2, and
+        // decimal integers of up to 16 digits are decoded 8 digits at a time.
+        // Empty text is an empty list, an empty field is invalid. On failure
+        // values is left as it was and the bad field is stored in field.
+        static convert_status to_integers(std::string_view text, char separator, std::pmr::vector<i64>& values, std::string_view* field = nullptr);
+        static convert_status to_floats(std::string_view text, char separator, std::pmr::vector<f64>& values, std::string_view* field = nullptr);
+
+        static const char* describe(convert_status status);
+
+    private:
+        static int strip_base_prefix(std::string_view& text, int base);
+    };
+}
+
+#endif
@@ -2,10 +2,12 @@
 #define ARGPARSE_DEFS_H
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <iostream>
 #include <exception>
 #include <map>
+#include <memory_resource>
 
 namespace argparse
 {
@@ -0,0 +1,32 @@
+#ifndef ARGPARSE_FLAG_SET_H
+#define ARGPARSE_FLAG_SET_H
+
+#include "argparse/defs.h"
+#include "argparse/span.h"
+
+namespace argparse
+{
+    // Read-only view of the flags of a flag family, one bit per flag in the
+    // order the flags were added, see parser::add_flag_family
+    class flag_set
+    {
+    public:
+        flag_set();
+        flag_set(const u64* words, u64 count);
+
+        // Number of flags in the family
+        u64 size() const;
+        // Whether flag number flag is enabled, false past the last flag
+        bool test(i32 flag) const;
+        // Number of enabled flags
+        u64 count() const;
+        // The bits, 64 flags to a word
+        span<const u64> words() const;
+
+    private:
+        const u64* bits;
+        u64 flags;
+    };
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,138 @@
+#ifndef ARGPARSE_HANDLE_H
+#define ARGPARSE_HANDLE_H
+
+#include "argparse/defs.h"
+#include "argparse/parameter.h"
+#include "argparse/parameter_none.h"
+#include "argparse/parameter_integer.h"
+#include "argparse/parameter_string.h"
+#include "argparse/parameter_float.h"
+#include "argparse/parameter_string_list.h"
+#include "argparse/parameter_integer_list.h"
+#include "argparse/parameter_float_list.h"
+#include "argparse/parameter_string_map.h"
+#include "argparse/parameter_flag_set.h"
+#include "argparse/value_table.h"
+
+namespace argparse
+{
+    // Maps a value type to the parameter class and type that store it, and to
+    // the types parse_result and batch_result hand it out as
+    template<typename T>
+    struct parameter_traits;
+
+    template<>
+    struct parameter_traits<bool>
+    {
+        typedef parameter_none parameter_class;
+        typedef bool result_type;
+        typedef u8 column_type;
+        static const parameter_type type = NONE;
+        static result_type from_table(const value_table& values, i32 id) { return values.cells[id].flag; }
+    };
+
+    template<>
+    struct parameter_traits<i64>
+    {
+        typedef parameter_integer parameter_class;
+        typedef i64 result_type;
+        typedef i64 column_type;
+        static const parameter_type type = INTEGER;
+        static result_type from_table(const value_table& values, i32 id) { return values.cells[id].integer; }
+    };
+
+    template<>
+    struct parameter_traits<f64>
+    {
+        typedef parameter_float parameter_class;
+        typedef f64 result_type;
+        typedef f64 column_type;
+        static const parameter_type type = FLOAT;
+        static result_type from_table(const value_table& values, i32 id) { return values.cells[id].real; }
+    };
+
+    template<>
+    struct parameter_traits<std::string>
+    {
+        typedef parameter_string parameter_class;
+        typedef std::string_view result_type;
+        typedef std::string_view column_type;
+        static const parameter_type type = STRING;
+        static result_type from_table(const value_table& values, i32 id) { return values.texts[id]; }
+    };
+
+    // Lists are read as spans of their packed values and have no batch column
+    template<>
+    struct parameter_traits<std::vector<std::string_view>>
+    {
+        typedef parameter_string_list parameter_class;
+        typedef span<const std::string_view> result_type;
+        static const parameter_type type = STRING_LIST;
+        static result_type from_table(const value_table& values, i32 id)
+        {
+            return result_type(values.items.data() + values.cells[id].range.offset, values.cells[id].range.count);
+        }
+    };
+
+    template<>
+    struct parameter_traits<std::vector<i64>>
+    {
+        typedef parameter_integer_list parameter_class;
+        typedef span<const i64> result_type;
+        static const parameter_type type = INTEGER_LIST;
+        static result_type from_table(const value_table& values, i32 id)
+        {
+            return result_type(values.integer_items.data() + values.cells[id].range.offset, values.cells[id].range.count);
+        }
+    };
+
+    template<>
+    struct parameter_traits<std::vector<f64>>
+    {
+        typedef parameter_float_list parameter_class;
+        typedef span<const f64> result_type;
+        static const parameter_type type = FLOAT_LIST;
+        static result_type from_table(const value_table& values, i32 id)
+        {
+            return result_type(values.real_items.data() + values.cells[id].range.offset, values.cells[id].range.count);
+        }
+    };
+
+    // Maps are read as a view of their hash table and have no batch column
+    template<>
+    struct parameter_traits<string_map>
+    {
+        typedef parameter_string_map parameter_class;
+        typedef string_map result_type;
+        static const parameter_type type = STRING_MAP;
+        static result_type from_table(const value_table& values, i32 id) { return values.map(id); }
+    };
+
+    // Flag families are read as a view of their bits and have no batch column
+    template<>
+    struct parameter_traits<flag_set>
+    {
+        typedef parameter_flag_set parameter_class;
+        typedef flag_set result_type;
+        static const parameter_type type = FLAG_SET;
+        static result_type from_table(const value_table& values, i32 id) { return values.flags(id); }
+    };
+
+    // Typed reference to a registered option, returned by parser::add_parameter<T>.
+    // Reading through a handle is a direct index into the parser's options.
+    template<typename T>
+    class handle
+    {
+    public:
+        handle() : id(-1) {}
+        explicit handle(i32 id) : id(id) {}
+
+        i32 get_id() const { return this->id; }
+        bool is_valid() const { return this->id >= 0; }
+
+    private:
+        i32 id;
+    };
+}
+
+#endif
@@ -0,0 +1,24 @@
+#ifndef ARGPARSE_HASH_H
+#define ARGPARSE_HASH_H
+
+#include "argparse/defs.h"
+
+namespace argparse
+{
+    const u64 FNV_OFFSET_BASIS = 14695981039346656037ull;
+
+    // FNV-1a hash of text, starting from basis; the option index, map values
+    // and compile-time tables all hash names with it
+    constexpr u64 fnv1a(std::string_view text, u64 basis = FNV_OFFSET_BASIS)
+    {
+        u64 h = basis;
+        for (char c : text)
+        {
+            h ^= (u8)c;
+            h *= 1099511628211ull;
+        }
+        return h;
+    }
+}
+
+#endif
\ No newline at end of file
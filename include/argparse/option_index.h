@@ -0,0 +1,55 @@
+#ifndef ARGPARSE_OPTION_INDEX_H
+#define ARGPARSE_OPTION_INDEX_H
+
+#include "argparse/defs.h"
+
+namespace argparse
+{
+    // Name lookup for registered options. Single character short names are
+    // resolved through a 256 entry direct table, every other name through an
+    // open-addressing hash table. Lookups never allocate. The names are not
+    // copied: the caller keeps them alive for as long as the index is used.
+    class option_index
+    {
+    public:
+        // Tables are allocated from resource
+        option_index(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+        void add_short(std::string_view short_name, i32 id);
+        void add_long(std::string_view name, i32 id);
+        void clear();
+
+        // Return the id registered for the name, or -1 if there is none
+        i32 find_short(std::string_view short_name) const;
+        i32 find_long(std::string_view name) const;
+
+    private:
+        struct slot
+        {
+            u64 hash;
+            std::string_view name;
+            i32 id;
+        };
+
+        class table
+        {
+        public:
+            table(std::pmr::memory_resource* resource);
+            void insert(std::string_view name, i32 id);
+            i32 find(std::string_view name) const;
+            void clear();
+        private:
+            void grow();
+            std::pmr::vector<slot> slots;
+            u64 count;
+        };
+
+        static u64 hash(std::string_view name);
+
+        i32 short_table[256];
+        table short_names;
+        table names;
+    };
+}
+
+#endif
@@ -2,36 +2,68 @@
 #define ARGPARSE_PARAMETER_H
 
 #include "argparse/defs.h"
+#include "argparse/span.h"
+#include "argparse/string_map.h"
+#include "argparse/flag_set.h"
 
 namespace argparse
 {
     enum parameter_type
     {
-        NONE, INTEGER, STRING, FLOAT
+        NONE, INTEGER, STRING, FLOAT, STRING_LIST, INTEGER_LIST, FLOAT_LIST, STRING_MAP, FLAG_SET
+    };
+
+    // Value of one option as parameters store and capture it. Only the member
+    // matching the option's type is used, text points into the parsed tokens.
+    struct value_slot
+    {
+        bool present;
+        bool flag;
+        i64 integer;
+        f64 real;
+        std::string_view text;
+        span<const std::string_view> items;
+        span<const i64> integers;
+        span<const f64> reals;
+        string_map map;
+        flag_set flags;
     };
 
     class parameter
     {
     public:
-        parameter(std::string short_name, std::string name, std::string description, parameter_type type);
+        // Names and description are copied into memory from resource
+        parameter(std::string_view short_name, std::string_view name, std::string_view description, parameter_type type, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
         virtual ~parameter();
 
-        std::string get_short_name();
-        std::string get_name();
-        std::string get_description();
+        std::string_view get_short_name() const;
+        std::string_view get_name() const;
+        std::string_view get_description() const;
         
-        virtual void set(std::string);
+        // Store a value given as text, returns false if the text is not a valid value
+        virtual bool set(std::string_view);
         virtual void get_value_to(void*);
 
+        // Store a converted value in this parameter
+        virtual void assign(const value_slot& slot);
+        // Record the current value as the default of results; text in the
+        // slot stays valid for the lifetime of the parameter
+        virtual void capture_default(value_slot& slot);
+
         void set_required(bool);
-        bool get_required();
+        bool get_required() const;
+
+        // Default value as given at registration, converted only when first needed
+        void set_default_text(std::string_view text);
+        std::string_view get_default_text() const;
 
-        parameter_type get_type();
+        parameter_type get_type() const;
 
     private:
-        std::string short_name;
-        std::string name;
-        std::string description;
+        std::pmr::string short_name;
+        std::pmr::string name;
+        std::pmr::string description;
+        std::pmr::string default_text;
         parameter_type type;
         
         bool required;
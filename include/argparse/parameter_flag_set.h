@@ -0,0 +1,48 @@
+#ifndef ARGPARSE_PARAMETER_FLAG_SET_H
+#define ARGPARSE_PARAMETER_FLAG_SET_H
+
+#include "argparse/defs.h"
+#include "argparse/parameter.h"
+#include "argparse/option_index.h"
+
+namespace argparse
+{
+    // A family of boolean flags under common prefixes, such as -fname and
+    // -fno-name. The flags are bits of one value, and their names are found
+    // through one hash table instead of one option each.
+    class parameter_flag_set : public parameter
+    {
+    public:
+        parameter_flag_set(std::string_view short_name, std::string_view name, std::string_view description, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+        virtual ~parameter_flag_set();
+        void get_value_to(void*) override;
+        void assign(const value_slot& slot) override;
+        void capture_default(value_slot& slot) override;
+        const flag_set& get_value() const;
+
+        // Prefixes of the tokens that enable and disable a flag, such as "-f"
+        // and "-fno-"
+        void set_prefixes(std::string_view enable, std::string_view disable);
+        std::string_view get_enable_prefix() const;
+        std::string_view get_disable_prefix() const;
+
+        // Add a flag, returns its number or -1 if the name is already taken
+        i32 add_flag(std::string_view name, bool enabled);
+        // Number of the flag named name, or -1
+        i32 find_flag(std::string_view name) const;
+        // Number of the flag a token such as -fname or -fno-name switches, or
+        // -1, and whether the token enables it
+        i32 match(std::string_view token, bool& enabled) const;
+    private:
+        std::pmr::string enable_prefix;
+        std::pmr::string disable_prefix;
+        // flag names are copied here once and never move, the index refers to them
+        std::pmr::monotonic_buffer_resource names_memory;
+        option_index names;
+        std::pmr::vector<u64> default_words;
+        i32 count;
+        flag_set value;
+    };
+}
+
+#endif
\ No newline at end of file
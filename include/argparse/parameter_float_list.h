@@ -0,0 +1,30 @@
+#ifndef ARGPARSE_PARAMETER_FLOAT_LIST_H
+#define ARGPARSE_PARAMETER_FLOAT_LIST_H
+
+#include "argparse/defs.h"
+#include "argparse/parameter.h"
+
+namespace argparse
+{
+    // Any number of floating point values, given as repeated options or comma separated lists
+    class parameter_float_list : public parameter
+    {
+    public:
+        parameter_float_list(std::string_view short_name, std::string_view name, std::string_view description, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+        virtual ~parameter_float_list();
+        bool set(std::string_view) override;
+        void get_value_to(void*) override;
+        void assign(const value_slot& slot) override;
+        void capture_default(value_slot& slot) override;
+        const std::vector<f64>& get_value() const;
+
+        // Store values in the caller's variable instead of in this parameter
+        void bind(std::vector<f64>* target);
+    private:
+        std::vector<f64> value;
+        std::vector<f64>* target;
+        std::pmr::vector<f64> default_value;
+    };
+}
+
+#endif
\ No newline at end of file
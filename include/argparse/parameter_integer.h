@@ -9,12 +9,22 @@ namespace argparse
     class parameter_integer : public parameter
     {
     public:
-        parameter_integer(std::string short_name, std::string name, std::string description, int base = 10, bool is_signed = true);
+        parameter_integer(std::string_view short_name, std::string_view name, std::string_view description, int base = 10, bool is_signed = true, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
         virtual ~parameter_integer();
-        void set(std::string) override;
-        void get_value_to(void*) override;
+        bool set(std::string_view) override;
+        void get_value_to(void*) override;
+        void assign(const value_slot& slot) override;
+        void capture_default(value_slot& slot) override;
+        const i64& get_value() const;
+
+        // Store values in the caller's variable instead of in this parameter
+        void bind(i64* target);
+
+        int get_base() const;
+        bool get_signed() const;
     private:
         i64 value;
+        i64* target;
         int base;
         bool is_signed;
     };
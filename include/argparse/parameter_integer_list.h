@@ -0,0 +1,30 @@
+#ifndef ARGPARSE_PARAMETER_INTEGER_LIST_H
+#define ARGPARSE_PARAMETER_INTEGER_LIST_H
+
+#include "argparse/defs.h"
+#include "argparse/parameter.h"
+
+namespace argparse
+{
+    // Any number of integers, given as repeated options or comma separated lists
+    class parameter_integer_list : public parameter
+    {
+    public:
+        parameter_integer_list(std::string_view short_name, std::string_view name, std::string_view description, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+        virtual ~parameter_integer_list();
+        bool set(std::string_view) override;
+        void get_value_to(void*) override;
+        void assign(const value_slot& slot) override;
+        void capture_default(value_slot& slot) override;
+        const std::vector<i64>& get_value() const;
+
+        // Store values in the caller's variable instead of in this parameter
+        void bind(std::vector<i64>* target);
+    private:
+        std::vector<i64> value;
+        std::vector<i64>* target;
+        std::pmr::vector<i64> default_value;
+    };
+}
+
+#endif
\ No newline at end of file
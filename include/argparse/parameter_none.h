@@ -9,13 +9,20 @@ namespace argparse
     class parameter_none : public parameter
     {
     public:
-        parameter_none(std::string short_name, std::string name, std::string description);
+        parameter_none(std::string_view short_name, std::string_view name, std::string_view description, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
         virtual ~parameter_none();
-        void set(std::string) override;
-        void get_value_to(void*) override;
+        bool set(std::string_view) override;
+        void get_value_to(void*) override;
+        void assign(const value_slot& slot) override;
+        void capture_default(value_slot& slot) override;
+        const bool& get_value() const;
+
+        // Store values in the caller's variable instead of in this parameter
+        void bind(bool* target);
 
     private:
         bool is_set;
+        bool* target;
     };
 }
 
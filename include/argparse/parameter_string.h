@@ -9,12 +9,20 @@ namespace argparse
     class parameter_string : public parameter
     {
     public:
-        parameter_string(std::string short_name, std::string name, std::string description);
+        parameter_string(std::string_view short_name, std::string_view name, std::string_view description, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
         virtual ~parameter_string();
-        void set(std::string) override;
-        void get_value_to(void*) override;
+        bool set(std::string_view) override;
+        void get_value_to(void*) override;
+        void assign(const value_slot& slot) override;
+        void capture_default(value_slot& slot) override;
+        const std::string& get_value() const;
+
+        // Store values in the caller's variable instead of in this parameter
+        void bind(std::string* target);
     private:
         std::string value;
+        std::string* target;
+        std::pmr::string default_value;
     };
 }
 
@@ -0,0 +1,33 @@
+#ifndef ARGPARSE_PARAMETER_STRING_LIST_H
+#define ARGPARSE_PARAMETER_STRING_LIST_H
+
+#include "argparse/defs.h"
+#include "argparse/parameter.h"
+
+namespace argparse
+{
+    // Any number of text values, given as repeated options such as -I a -I b,
+    // or the variadic positional argument. The values are views into the
+    // parser's copy of them after its own parse of a vector or argv, and
+    // otherwise into the parsed tokens, which must outlive them.
+    class parameter_string_list : public parameter
+    {
+    public:
+        parameter_string_list(std::string_view short_name, std::string_view name, std::string_view description, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+        virtual ~parameter_string_list();
+        bool set(std::string_view) override;
+        void get_value_to(void*) override;
+        void assign(const value_slot& slot) override;
+        void capture_default(value_slot& slot) override;
+        const std::vector<std::string_view>& get_value() const;
+
+        // Store values in the caller's variable instead of in this parameter
+        void bind(std::vector<std::string_view>* target);
+    private:
+        std::vector<std::string_view> value;
+        std::vector<std::string_view>* target;
+        std::pmr::vector<std::string_view> default_value;
+    };
+}
+
+#endif
\ No newline at end of file
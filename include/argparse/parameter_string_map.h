@@ -0,0 +1,30 @@
+#ifndef ARGPARSE_PARAMETER_STRING_MAP_H
+#define ARGPARSE_PARAMETER_STRING_MAP_H
+
+#include "argparse/defs.h"
+#include "argparse/parameter.h"
+
+namespace argparse
+{
+    // Definitions KEY=VALUE given as repeated options, such as -DNAME=VALUE or
+    // --set a.b=c. The value is a view of the last parse's table, valid
+    // until the next parse.
+    class parameter_string_map : public parameter
+    {
+    public:
+        parameter_string_map(std::string_view short_name, std::string_view name, std::string_view description, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+        virtual ~parameter_string_map();
+        void get_value_to(void*) override;
+        void assign(const value_slot& slot) override;
+        void capture_default(value_slot& slot) override;
+        const string_map& get_value() const;
+
+        // Store values in the caller's variable instead of in this parameter
+        void bind(string_map* target);
+    private:
+        string_map value;
+        string_map* target;
+    };
+}
+
+#endif
\ No newline at end of file
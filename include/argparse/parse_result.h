@@ -0,0 +1,70 @@
+#ifndef ARGPARSE_PARSE_RESULT_H
+#define ARGPARSE_PARSE_RESULT_H
+
+#include "argparse/defs.h"
+#include "argparse/parameter.h"
+#include "argparse/handle.h"
+#include "argparse/value_table.h"
+
+namespace argparse
+{
+    class parser;
+
+    // Values of one parse, kept apart from the parser that describes the
+    // options. A const parser can fill any number of results concurrently.
+    // String values point into the parsed tokens, which must outlive the
+    // result. A result can be reused for the next parse without allocating.
+    // With deferred conversion a value is converted on its first read, so
+    // such a result must not be read from several threads at once.
+    class parse_result
+    {
+    public:
+        // Slots are allocated from resource
+        parse_result(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+        // Value of an option, or its default when it was not given
+        template<typename T>
+        typename parameter_traits<T>::result_type get(handle<T> h) const
+        {
+            return parameter_traits<T>::from_table(resolve(h.get_id()), h.get_id());
+        }
+
+        // Whether the option was given on the command line
+        template<typename T>
+        bool is_set(handle<T> h) const
+        {
+            return (this->values.states[h.get_id()] & value_table::PRESENT) != 0;
+        }
+
+        // Same lookup rules and value types as parser::get_parameter_value_to
+        bool get_parameter_value_to(std::string_view flag, void* value_buf) const;
+
+        std::string_view get_program_name() const;
+        const std::string& get_error() const;
+
+    private:
+        friend class parser;
+
+        // The values, after converting the option's value if it is deferred
+        const value_table& resolve(i32 id) const;
+
+        const parser* spec;
+        mutable value_table values;
+        // version of the defaults values started from, see parser::restore_defaults
+        u64 defaults_version;
+        std::string_view program_name;
+        mutable std::string error;
+        // values of list options in the order given, grouped by option and
+        // converted once every token is parsed, see parser::assign_lists
+        struct list_value
+        {
+            i32 id;
+            std::string_view text;
+        };
+        std::pmr::vector<list_value> lists;
+        std::pmr::vector<list_value> list_scratch;
+        std::pmr::vector<u32> list_counts;
+    };
+}
+
+#endif
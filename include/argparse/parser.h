@@ -3,6 +3,17 @@
 
 #include "argparse/defs.h"
 #include "argparse/util.h"
+#include "argparse/token_list.h"
+#include "argparse/token_classify.h"
+#include "argparse/token_stream.h"
+#include "argparse/option_index.h"
+#include "argparse/handle.h"
+#include "argparse/parse_result.h"
+#include "argparse/batch.h"
+#include "argparse/process_scan.h"
+#include <atomic>
+#include <functional>
+#include <mutex>
 
 namespace argparse
 {
@@ -11,31 +22,273 @@ namespace argparse
     {
     public:
         parser();
+        // Allocate the options, their names and descriptions and the lookup tables
+        // from resource, for example a std::pmr::monotonic_buffer_resource that
+        // outlives the parser. Releasing the resource then frees everything at once.
+        explicit parser(std::pmr::memory_resource* resource);
         virtual ~parser();
 
-        void add_parameter(std::string short_name, std::string name, std::string description, parameter_type type=NONE, bool required=false, std::string default_value=std::string(""));
+        // Register an option of the given type. An option with a name that
+        // another option already uses is not added; the conflict is reported
+        // on std::cerr.
+        void add_parameter(std::string_view short_name, std::string_view name, std::string_view description, parameter_type type=NONE, bool required=false, std::string_view default_value=std::string_view());
+
+        // Register an option whose type follows from T (bool, i64, f64 or std::string).
+        // Registering the same names again replaces the option; with another
+        // type the old option is only kept for its handles, and is neither
+        // parsed nor listed in the help. A name that another option already
+        // uses gives an invalid handle, and is reported on std::cerr.
+        template<typename T>
+        handle<T> add_parameter(std::string_view short_name, std::string_view name, std::string_view description, bool required=false, std::string_view default_value=std::string_view())
+        {
+            return handle<T>(register_parameter(short_name, name, description, parameter_traits<T>::type, required, default_value));
+        }
+
+        // Bind an option to a variable owned by the caller. parse() converts values
+        // straight into the variable, and its current value acts as the default.
+        template<typename T>
+        handle<T> add_parameter(std::string_view short_name, std::string_view name, std::string_view description, T& variable, bool required=false)
+        {
+            typedef typename parameter_traits<T>::parameter_class parameter_class;
+            i32 id = register_parameter(short_name, name, description, parameter_traits<T>::type, required);
+            if (id >= 0)
+            {
+                static_cast<parameter_class*>(parameters[id])->bind(&variable);
+                capture_bound_default(id);
+            }
+            return handle<T>(id);
+        }
+
+        // Declare a positional argument, one of the tokens that are not options.
+        // Positionals are filled in declaration order: a required one always
+        // takes a token, an optional one only when more tokens are given than
+        // the required ones need, and otherwise reads as default_value.
+        template<typename T>
+        handle<T> add_positional(std::string_view name, std::string_view description, bool required = true, std::string_view default_value = std::string_view())
+        {
+            static_assert(parameter_traits<T>::type != NONE && parameter_traits<T>::type != STRING_LIST, "a positional takes a value");
+            return handle<T>(register_positional(name, description, parameter_traits<T>::type, required, default_value));
+        }
+
+        // Declare the variadic positional, which takes every token the others
+        // leave, at least one if required. Its values are one span of views
+        // into the parsed tokens, so paths are not allocated one by one. A
+        // parse into a parse_result or of a span keeps them as views, valid
+        // while the tokens are; the parser's own parse of a vector or argv
+        // copies their text into one buffer it owns, valid until its next
+        // parse. A parser has at most one; another returns an invalid handle.
+        handle<std::vector<std::string_view>> add_variadic(std::string_view name, std::string_view description, bool required = false);
+
+        // Declare a family of boolean flags switched by tokens such as -fname
+        // and -fno-name, or --enable-name and --disable-name, given the
+        // prefixes "-f" and "-fno-". The flags are bits of one flag_set value
+        // instead of options of their own, so thousands of them cost a name
+        // and a bit each; a token is resolved by a prefix match and one hash
+        // lookup once no option has its name. Returns an invalid handle unless
+        // both prefixes start with a dash.
+        handle<flag_set> add_flag_family(std::string_view name, std::string_view enable_prefix, std::string_view disable_prefix, std::string_view description);
+        // Add a flag to a family, returns its number in the family's flag_set,
+        // or -1 if the handle is not a family or the name is already taken
+        i32 add_flag(handle<flag_set> family, std::string_view name, bool enabled = false);
+        // Number of the flag of a family named name, or -1
+        i32 find_flag(handle<flag_set> family, std::string_view name) const;
+
+        // Read an option's value through its handle, without any name lookup.
+        // Every option holds its value once a parse finishes; a read before
+        // that converts the defaults still held as text first, as freeze does,
+        // after which a read costs one atomic load.
+        template<typename T>
+        const T& get(handle<T> h) const
+        {
+            typedef typename parameter_traits<T>::parameter_class parameter_class;
+            convert_defaults();
+            return static_cast<const parameter_class*>(parameters[h.get_id()])->get_value();
+        }
+
+        // Default values are kept as text and converted when first needed. freeze
+        // converts all of them in one pass once every option is added, so no
+        // later parse converts a default. With validate_defaults an invalid
+        // default is reported on std::cerr and freeze returns false.
+        bool freeze(bool validate_defaults = false);
 
         std::string get_help_message();
 
-        bool parse(std::vector<std::string> args);
+        bool parse(const std::vector<std::string>& args);
         bool parse(int argc, char** argv);
 
-        bool get_parameter_value_to(std::string flag, void* value_buf);
+        // Parse into a separate result, leaving the parser untouched. Any number
+        // of threads may do this at once once options are no longer being added.
+        // No help is printed and the process never exits; on failure the message
+        // is available from result.get_error().
+        bool parse(const std::vector<std::string>& args, parse_result& result) const;
+        bool parse(int argc, const char* const* argv, parse_result& result) const;
+
+        // Parse tokens held elsewhere, such as those of response_files, which
+        // must outlive the values read from them
+        bool parse(span<const std::string_view> args);
+        bool parse(span<const std::string_view> args, parse_result& result) const;
+
+        // Parse a buffer of NUL separated arguments, program name first, as read
+        // from /proc/<pid>/cmdline, without splitting it into strings first
+        bool parse_cmdline(std::string_view cmdline, parse_result& result) const;
+
+        // Parse tokens read incrementally from a file descriptor or stream,
+        // separated by delimiter ('\0' for find -print0 output, '\n' for one
+        // token per line). Options are stored as by parse; every other token
+        // is passed to positional, valid only during the call, or without a
+        // callback goes to the declared positionals as for parse. Only the
+        // current chunk and the last value of each option are held, so memory
+        // does not grow with the stream, except by the values of list options
+        // and of positionals without a callback, which are kept together in
+        // one buffer reused by the next stream. The stream has no program name.
+        bool parse_stream(int fd, char delimiter = '\0', const std::function<void(std::string_view)>& positional = nullptr);
+        bool parse_stream(std::istream& in, char delimiter = '\0', const std::function<void(std::string_view)>& positional = nullptr);
+        bool parse_stream(token_stream& tokens, const std::function<void(std::string_view)>& positional = nullptr);
+
+        // Parse many command lines at once on a work-stealing pool of thread_count
+        // threads (0 for one per hardware thread). Returns true if every row parsed.
+        bool parse_batch(span<const arg_vector> inputs, batch_result& results, u32 thread_count = 0) const;
+        // Same for the command lines of a process scan, one row per process
+        bool parse_batch(const process_scan& processes, batch_result& results, u32 thread_count = 0) const;
+
+        // Looking up a flag never modifies the parser
+        bool get_parameter_value_to(std::string_view flag, void* value_buf);
 
         // Auto-help configuration
         void set_auto_help(bool enable);
 
+        // With deferred conversion a parse only checks the tokens and keeps a view
+        // of each value, which is converted and cached the first time it is read.
+        // The parsed tokens must then outlive those reads. An invalid value is
+        // reported when it is read (in parse_result::get_error) and reads as the
+        // default. The parser's own values are converted when parse finishes,
+        // where an invalid one is reported on std::cerr.
+        void set_deferred_conversion(bool enable);
+
     private:
-        std::map<std::string, parameter*> parameters;
-        std::string program_name;
+        friend class parse_result;
+
+        // everything below is allocated from here
+        std::pmr::memory_resource* resource;
+
+        // options in registration order, addressed by the ids in index
+        std::pmr::vector<parameter*> parameters;
+        option_index index;
+        std::pmr::string program_name;
+
+        // type tag of every option, and base and signedness of integer options,
+        // so parsing converts values without calling into the parameters
+        std::pmr::vector<u8> types;
+        std::pmr::vector<u8> integer_formats;
 
-        std::map<std::string, std::string> short_name_query;
-        std::map<std::string, std::string> name_query;
+        // value of every option when it is not given, and whether it is
+        // converted yet (default_state flags)
+        mutable value_table defaults;
+        mutable std::pmr::vector<u8> default_states;
+        // changes whenever defaults does, unique across parsers
+        mutable u64 defaults_version;
+        // set once no default is left to convert and every option holds its
+        // value, guarded by values_lock
+        mutable std::atomic<bool> values_ready;
+        mutable std::mutex values_lock;
+        // result of the last stateful parse
+        parse_result state;
+        // ids of the options holding a value of the last stateful parse rather
+        // than their default, and whether some default is not assigned yet
+        std::pmr::vector<i32> assigned;
+        bool unassigned_defaults;
+        // ids of the positionals in declaration order, and of the variadic
+        // one or -1
+        std::pmr::vector<i32> positionals;
+        i32 variadic;
+        // ids of the flag families, tried in declaration order
+        std::pmr::vector<i32> families;
+        // values of the last parse_stream, which state's texts point to, as
+        // the stream's own buffer is reused
+        std::pmr::vector<std::pmr::string> stream_texts;
+        // values of list options and positionals of the last parse_stream,
+        // back to back, and where each one is; the views of state are pointed
+        // into it only once the stream ends, as it moves while it grows
+        std::pmr::string stream_values;
+        std::pmr::vector<value_range> stream_lists;
+        std::pmr::vector<value_range> stream_positionals;
+        // values of text lists and maps of the last parse of a vector or argv,
+        // which are views into tokens the caller may destroy
+        std::pmr::string list_texts;
 
         bool auto_help_enabled;
+        bool deferred_conversion;
+
+        i32 register_parameter(std::string_view short_name, std::string_view name, std::string_view description, parameter_type type, bool required, std::string_view default_value);
+        i32 register_parameter(std::string_view short_name, std::string_view name, std::string_view description, parameter_type type, bool required);
+        // Positionals are kept out of the option index
+        i32 register_positional(std::string_view name, std::string_view description, parameter_type type, bool required, std::string_view default_value);
+        // Append the table entries of a new option
+        i32 append_parameter(parameter* p_parameter);
+        // Whether an option of another type has taken over the names of an
+        // option, which is then only kept for its handles
+        bool is_replaced(i32 id) const;
+        // Keep a default as text, or capture the parameter's current value
+        void set_default(i32 id, std::string_view default_value);
+
+        void capture_default(i32 id);
+        // Same for an option bound to a variable, which is always assigned eagerly
+        void capture_bound_default(i32 id);
+
+        // Converted default of an option, converting its text on first use
+        value_slot default_slot(i32 id) const;
+        // Give an option its value from the last parse, or its default, if it
+        // does not hold it yet
+        void assign_value(i32 id);
+        void assign_pending(i32 id) const;
+        // Convert a deferred value in place, an invalid one becomes the default
+        bool convert_deferred(i32 id, value_table& values) const;
+        // Convert text into the option's entry of values, by a switch on its type
+        bool convert_text(i32 id, std::string_view text, value_table& values) const;
+        // Long name of an option, or its short name if it has none
+        std::string_view option_name(i32 id) const;
+        // Convert every remaining default, safe to call from concurrent parses
+        void convert_defaults() const;
+
+        // Give the values of result those of defaults, resetting only what its
+        // last parse changed when that parse started from the same defaults
+        void restore_defaults(parse_result& result) const;
+        // Walks the tokens in place without copying them; with own_lists the
+        // values kept as views are then copied, as the tokens may not outlive
+        // the parse
+        bool parse_tokens(const token_list& args, bool own_lists);
+        // Copy the values of the text lists of the last parse, the variadic
+        // among them, and the keys and values of its maps into list_texts and
+        // point them there
+        void own_list_values();
+        // With defer, values are kept as text for convert_deferred
+        bool parse_tokens(const token_list& args, parse_result& result, bool defer) const;
+        bool parse_stream_tokens(token_stream& tokens, const std::function<void(std::string_view)>& positional);
+        // Parse one option token, "--name", "--name=value" or a cluster of short
+        // options such as "-vx", "-ofile" or "-n-5", splitting it in place.
+        // next(value, kind) reads the following token for an option that takes
+        // it as its value, store(id, value) keeps or converts a value.
+        template<typename N, typename S>
+        bool parse_option(std::string_view token, token_kind kind, u32 separator, parse_result& result, N next, S store) const;
+        // Switch the flag a token such as -fname names in values, false if no
+        // family has it
+        bool parse_flag(std::string_view token, value_table& values) const;
+        // Hand the positional tokens, items of result from first on, to the
+        // declared positionals
+        bool assign_positionals(parse_result& result, u64 first, bool defer) const;
+        // Convert the values of list options, packing each option's values
+        // together in the order given, and build the table of each map option
+        bool assign_lists(parse_result& result) const;
+        // Report a failed stateful parse, or give every option its new value
+        bool finish_parse(bool parsed);
+        // parse_batch over rows whose tokens come from row_tokens
+        bool parse_rows(u64 rows, const std::function<token_list(u64)>& row_tokens, batch_result& results, u32 thread_count) const;
+
+        // Resolve "-f", "--flag" or a bare name to an option id, -1 if unknown
+        i32 find_parameter(std::string_view flag) const;
 
         // Helper methods for auto-help
-        bool is_help_requested();
+        bool is_help_requested() const;
         void print_help_and_exit();
 
     };
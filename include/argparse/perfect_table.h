@@ -0,0 +1,144 @@
+#ifndef ARGPARSE_PERFECT_TABLE_H
+#define ARGPARSE_PERFECT_TABLE_H
+
+#include "argparse/defs.h"
+#include "argparse/hash.h"
+#include <array>
+
+namespace argparse
+{
+    // Smallest power of two, at least 2, that is not below n
+    constexpr u64 next_power_of_two(u64 n)
+    {
+        u64 power = 2;
+        while (power < n)
+        {
+            power *= 2;
+        }
+        return power;
+    }
+
+    // Collision free hash table over a fixed set of up to N names, built by a
+    // constexpr constructor so a constexpr table costs nothing at run time.
+    // Names are first hashed into a bucket; every bucket stores a seed that
+    // places all of its names in distinct slots (hash and displace). A lookup
+    // is two hashes and one comparison. Empty names are skipped, the id of a
+    // name is its position in the key array.
+    template<u64 N>
+    class perfect_table
+    {
+    public:
+        // at most half of the slots are used, which keeps the seed search short
+        static constexpr u64 size = next_power_of_two(N * 2);
+
+        constexpr perfect_table(const std::array<std::string_view, N>& keys)
+            : seeds(), slots(), ids()
+        {
+            for (u64 i = 0; i < size; i++)
+            {
+                this->ids[i] = -1;
+            }
+
+            // place the largest buckets first, while most slots are still free
+            std::array<u64, N> key_buckets{};
+            std::array<u64, size> bucket_sizes{};
+            u64 largest = 0;
+            for (u64 i = 0; i < N; i++)
+            {
+                key_buckets[i] = hash(keys[i], 0) & (size - 1);
+                if (!keys[i].empty())
+                {
+                    u64 count = ++bucket_sizes[key_buckets[i]];
+                    largest = count > largest ? count : largest;
+                }
+            }
+            for (u64 count = largest; count > 0; count--)
+            {
+                for (u64 bucket = 0; bucket < size; bucket++)
+                {
+                    if (bucket_sizes[bucket] == count)
+                    {
+                        place(keys, key_buckets, bucket);
+                    }
+                }
+            }
+        }
+
+        // Return the id of the name, or -1 if it is not in the table
+        constexpr i32 find(std::string_view name) const
+        {
+            u64 slot = hash(name, this->seeds[hash(name, 0) & (size - 1)]) & (size - 1);
+            return this->ids[slot] >= 0 && this->slots[slot] == name ? this->ids[slot] : -1;
+        }
+
+    private:
+        // FNV-1a with the seed folded into the basis, then mixed so the low
+        // bits depend on every character
+        static constexpr u64 hash(std::string_view name, u32 seed)
+        {
+            u64 h = fnv1a(name, FNV_OFFSET_BASIS ^ (seed * 0x9e3779b97f4a7c15ull));
+            h ^= h >> 29;
+            h *= 0xbf58476d1ce4e5b9ull;
+            h ^= h >> 32;
+            return h;
+        }
+
+        constexpr void place(const std::array<std::string_view, N>& keys, const std::array<u64, N>& key_buckets, u64 bucket)
+        {
+            // the names in this bucket; equal names always share a bucket
+            std::array<u64, N> members{};
+            u64 count = 0;
+            for (u64 i = 0; i < N; i++)
+            {
+                if (!keys[i].empty() && key_buckets[i] == bucket)
+                {
+                    for (u64 m = 0; m < count; m++)
+                    {
+                        if (keys[members[m]] == keys[i])
+                        {
+                            throw "argparse: option name registered twice";
+                        }
+                    }
+                    members[count++] = i;
+                }
+            }
+
+            for (u32 seed = 1; seed < 1000000; seed++)
+            {
+                bool fits = true;
+                for (u64 m = 0; m < count && fits; m++)
+                {
+                    u64 slot = hash(keys[members[m]], seed) & (size - 1);
+                    fits = this->ids[slot] == -1;
+                    // claim the slot so the bucket's other names must avoid it
+                    this->ids[slot] = fits ? -2 : this->ids[slot];
+                }
+                for (u64 m = 0; m < count; m++)
+                {
+                    u64 slot = hash(keys[members[m]], seed) & (size - 1);
+                    if (fits)
+                    {
+                        this->slots[slot] = keys[members[m]];
+                        this->ids[slot] = (i32)members[m];
+                    }
+                    else if (this->ids[slot] == -2)
+                    {
+                        this->ids[slot] = -1;
+                    }
+                }
+                if (fits)
+                {
+                    this->seeds[bucket] = seed;
+                    return;
+                }
+            }
+            throw "argparse: no perfect hash found for the option names";
+        }
+
+        std::array<u32, size> seeds;
+        std::array<std::string_view, size> slots;
+        std::array<i32, size> ids;
+    };
+}
+
+#endif
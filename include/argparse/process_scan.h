@@ -0,0 +1,48 @@
+#ifndef ARGPARSE_PROCESS_SCAN_H
+#define ARGPARSE_PROCESS_SCAN_H
+
+#include "argparse/defs.h"
+
+namespace argparse
+{
+    // Command lines of the running processes of one program, read from
+    // /proc/<pid>/cmdline (Linux only). All command lines are kept back to back
+    // in one buffer that is reused by the next scan, so scanning repeatedly
+    // does not allocate per process. Pass a scan to parser::parse_batch to get
+    // the option values of every process as columns:
+    //
+    //     argparse::process_scan processes;
+    //     processes.scan("server");
+    //     argparse::batch_result results;
+    //     spec.parse_batch(processes, results);
+    //     argparse::span<const argparse::i64> ports = results.column(port);
+    class process_scan
+    {
+    public:
+        explicit process_scan(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+        // Collect every process whose program name, argv[0] without its
+        // directory, is program; an empty program matches every process.
+        // Processes without a command line, such as kernel threads, and those
+        // that exit during the scan are skipped. Returns false if /proc cannot
+        // be read.
+        bool scan(std::string_view program);
+
+        u64 size() const;
+        i32 get_pid(u64 row) const;
+        // NUL separated arguments, valid until the next scan
+        std::string_view get_cmdline(u64 row) const;
+
+    private:
+        // read one command line to the end of buffer, returning its length
+        u64 read_cmdline(i32 pid);
+
+        std::pmr::vector<char> buffer;
+        u64 used;
+        // command line row is buffer[offsets[row], offsets[row + 1])
+        std::pmr::vector<u64> offsets;
+        std::pmr::vector<i32> pids;
+    };
+}
+
+#endif
@@ -0,0 +1,66 @@
+#ifndef ARGPARSE_RESPONSE_FILES_H
+#define ARGPARSE_RESPONSE_FILES_H
+
+#include "argparse/defs.h"
+#include "argparse/span.h"
+
+namespace argparse
+{
+    // Expands @path arguments into the tokens of the file at path, for command
+    // lines longer than ARG_MAX allows. Files are memory-mapped copy-on-write
+    // and tokenized in place: every token is a view into the mapping and only
+    // tokens with quotes or backslashes are rewritten, so a file is never read
+    // into separate strings.
+    //
+    // Tokens are separated by whitespace. Single quotes keep everything up to
+    // the closing quote, double quotes do the same but take \" and \\, and a
+    // backslash outside quotes keeps the next character. A token starting with
+    // an unquoted @ is expanded in turn, relative to the working directory; a
+    // file that includes itself is an error.
+    //
+    //     argparse::response_files files;
+    //     if (!files.expand(argc, argv)) { std::cerr << files.get_error() << std::endl; }
+    //     parser.parse(files.tokens());
+    class response_files
+    {
+    public:
+        explicit response_files(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+        ~response_files();
+
+        response_files(const response_files&) = delete;
+        response_files& operator=(const response_files&) = delete;
+
+        // Replace the tokens with args, every @path after the program name
+        // expanded. On failure the message is available from get_error().
+        bool expand(int argc, const char* const* argv);
+        bool expand(const std::vector<std::string>& args);
+
+        // Valid until the next expand or the destruction of this object
+        span<const std::string_view> tokens() const;
+        const std::string& get_error() const;
+
+    private:
+        struct mapping
+        {
+            char* data;
+            u64 size;
+            u64 device;
+            u64 inode;
+            // this file's tokens, nested files included, once it is expanded
+            u64 first;
+            u64 count;
+            bool expanding;
+        };
+
+        bool expand_token(std::string_view token);
+        bool expand_file(std::string_view path);
+        bool tokenize(u64 file, std::string_view path);
+        void release();
+
+        std::pmr::vector<mapping> files;
+        std::pmr::vector<std::string_view> token_views;
+        std::string error;
+    };
+}
+
+#endif
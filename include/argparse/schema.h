@@ -0,0 +1,375 @@
+#ifndef ARGPARSE_SCHEMA_H
+#define ARGPARSE_SCHEMA_H
+
+#include "argparse/defs.h"
+#include "argparse/convert.h"
+#include "argparse/perfect_table.h"
+#include "argparse/token_classify.h"
+#include "argparse/util.h"
+#include <array>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace argparse
+{
+    // One option of a schema: its names, description and the member of the
+    // values struct S that receives it. The member's type is the option's type
+    // (bool for a flag, any integer or floating point type, or std::string_view
+    // for text) and its initial value is the default.
+    template<typename S, typename T>
+    struct schema_option
+    {
+        std::string_view short_name;
+        std::string_view name;
+        std::string_view description;
+        T S::* member;
+    };
+
+    template<typename S, typename T>
+    constexpr schema_option<S, T> option(std::string_view short_name, std::string_view name, std::string_view description, T S::* member)
+    {
+        static_assert(std::is_same<T, bool>::value || std::is_integral<T>::value || std::is_floating_point<T>::value || std::is_same<T, std::string_view>::value,
+                      "option type must be bool, an integer, a floating point type or std::string_view");
+        return schema_option<S, T>{short_name, name, description, member};
+    }
+
+    // A complete option set fixed at compile time. Declared constexpr, its name
+    // lookup tables and help text are built by the compiler; parsing writes
+    // straight into a plain struct without allocating, without virtual calls
+    // and without any runtime tables. Text values point into argv.
+    //
+    //     struct options { bool verbose = false; i64 count = 1; };
+    //     constexpr auto spec = make_schema(
+    //         option("v", "verbose", "Enable verbose output", &options::verbose),
+    //         option("n", "count", "Number of iterations", &options::count));
+    template<typename S, typename... T>
+    class schema
+    {
+    public:
+        static constexpr u64 option_count = sizeof...(T);
+
+        constexpr schema(schema_option<S, T>... specs)
+            : options(specs...),
+              short_names{specs.short_name...},
+              names{specs.name...},
+              short_table(std::array<std::string_view, sizeof...(T)>{specs.short_name...}),
+              long_table(std::array<std::string_view, sizeof...(T)>{specs.name...}),
+              takes_value{!std::is_same<T, bool>::value...},
+              numeric{(std::is_arithmetic<T>::value && !std::is_same<T, bool>::value)...}
+        {
+            for (u64 id = 0; id < option_count; id++)
+            {
+                if (this->short_names[id].empty() && this->names[id].empty())
+                {
+                    throw "argparse: option has no name or short name";
+                }
+            }
+        }
+
+        // Id of an option from its short or long name, -1 if there is none
+        constexpr i32 find_short(std::string_view short_name) const
+        {
+            return this->short_table.find(short_name);
+        }
+
+        constexpr i32 find_long(std::string_view name) const
+        {
+            return this->long_table.find(name);
+        }
+
+        // Parse into values, whose members keep their value for options that are
+        // not given. On failure the message is stored in error if one is passed,
+        // worded as the runtime parser words it.
+        // Accepts the same forms: --name=value, clustered short options as in
+        // -vx, attached values as in -ofile, "--" ending the options, and a
+        // negative number as the next argument of a numeric option.
+        bool parse(int argc, const char* const* argv, S& values, std::string* error = nullptr) const
+        {
+            for (int i = 1; i < argc; i++)
+            {
+                std::string_view current = argv[i];
+                u32 separator = 0;
+                token_kind kind = classify_token(current, separator);
+                if (kind == TOKEN_TERMINATOR)
+                {
+                    if (i + 1 < argc)
+                    {
+                        return fail(error, "error: unexpected argument ", argv[i + 1], "");
+                    }
+                    continue;
+                }
+                if (kind == TOKEN_POSITIONAL)
+                {
+                    return fail(error, "error: unexpected argument ", current, "");
+                }
+
+                if (kind != TOKEN_SHORT)
+                {
+                    std::string_view name = current.substr(2, kind == TOKEN_LONG_VALUE ? separator - 2 : std::string_view::npos);
+                    i32 id = find_long(name);
+                    if (id < 0)
+                    {
+                        return fail(error, "error: unknown parameter ", name, "");
+                    }
+                    if (kind == TOKEN_LONG_VALUE && !this->takes_value[id])
+                    {
+                        return fail(error, "error: parameter ", name, " does not take a value");
+                    }
+                    bool stored = kind == TOKEN_LONG_VALUE ? store_text(id, name, current.substr(separator + 1), values, error)
+                                                           : store_next(id, name, argc, argv, i, values, error);
+                    if (!stored)
+                    {
+                        return false;
+                    }
+                    continue;
+                }
+
+                // the whole name first, as short names may be longer than
+                // one character, then one option per character
+                std::string_view body = current.substr(1);
+                i32 id = find_short(body);
+                if (id < 0 && body.size() < 2)
+                {
+                    return fail(error, "error: unknown parameter ", body, "");
+                }
+                for (u64 at = 0; at < body.size(); at++)
+                {
+                    std::string_view name = body;
+                    if (id < 0)
+                    {
+                        name = body.substr(at, 1);
+                        id = find_short(name);
+                        if (id < 0)
+                        {
+                            return fail(error, "error: unknown parameter ", at == 0 ? body : name, "");
+                        }
+                    }
+                    else
+                    {
+                        at = body.size() - 1;
+                    }
+                    std::string_view attached = body.substr(at + 1);
+                    if (this->takes_value[id])
+                    {
+                        if (!(attached.empty() ? store_next(id, name, argc, argv, i, values, error) : store_text(id, name, attached, values, error)))
+                        {
+                            return false;
+                        }
+                        break;
+                    }
+                    store_text(id, name, std::string_view(), values, error);
+                    id = -1;
+                }
+            }
+            return true;
+        }
+
+        // Length of the help text, and the text itself: one line per option,
+        // sorted by short name and then by long name, as in
+        // parser::get_help_message. Use as spec.help_text<spec.help_length()>().
+        constexpr u64 help_length() const
+        {
+            u64 length = 0;
+            for (u64 id = 0; id < option_count; id++)
+            {
+                length += help_line_length(id) + (id > 0 ? 1 : 0);
+            }
+            return length;
+        }
+
+        template<u64 L>
+        constexpr std::array<char, L + 1> help_text() const
+        {
+            if (L != help_length())
+            {
+                throw "argparse: help_text length must be help_length()";
+            }
+            std::array<char, L + 1> text{};
+            std::array<u64, sizeof...(T) + 1> order = help_order();
+            u64 at = 0;
+            for (u64 n = 0; n < option_count; n++)
+            {
+                u64 id = order[n];
+                if (n > 0)
+                {
+                    text[at++] = '\n';
+                }
+                if (!this->short_names[id].empty())
+                {
+                    at = append(text, at, "-");
+                    at = append(text, at, this->short_names[id]);
+                    at = append(text, at, ", ");
+                }
+                if (!this->names[id].empty())
+                {
+                    at = append(text, at, "--");
+                    at = append(text, at, this->names[id]);
+                }
+                at = append(text, at, "\t");
+                at = append(text, at, description(id, std::index_sequence_for<T...>()));
+            }
+            return text;
+        }
+
+    private:
+        bool store_text(i32 id, std::string_view name, std::string_view text, S& values, std::string* error) const
+        {
+            if (!store(id, text, values, std::index_sequence_for<T...>()))
+            {
+                return fail(error, "error: invalid value ", text, std::string(" for parameter ").append(name));
+            }
+            return true;
+        }
+
+        // Store an option written without a value, taking the next argument
+        // for one that needs it
+        bool store_next(i32 id, std::string_view name, int argc, const char* const* argv, int& i, S& values, std::string* error) const
+        {
+            if (!this->takes_value[id])
+            {
+                return store_text(id, name, std::string_view(), values, error);
+            }
+            i++;
+            std::string_view text = i < argc ? std::string_view(argv[i]) : std::string_view();
+            u32 separator = 0;
+            token_kind kind = classify_token(text, separator);
+            bool negative = this->numeric[id] && kind == TOKEN_SHORT && is_negative_number(text) && find_short(text.substr(1)) < 0;
+            if (i >= argc || (kind != TOKEN_POSITIONAL && !negative))
+            {
+                return fail(error, "error: parameter ", name, " requires a value");
+            }
+            return store_text(id, name, text, values, error);
+        }
+
+        // Build an error the way the runtime parser does, quoting only the
+        // start of a long subject
+        static bool fail(std::string* error, const char* prefix, std::string_view subject, std::string_view suffix)
+        {
+            if (error != nullptr)
+            {
+                error->assign(prefix);
+                util::append_value(*error, subject);
+                error->append(suffix);
+            }
+            return false;
+        }
+
+        static bool store_value(bool& value, std::string_view)
+        {
+            value = true;
+            return true;
+        }
+
+        static bool store_value(std::string_view& value, std::string_view text)
+        {
+            value = text;
+            return true;
+        }
+
+        template<typename V>
+        static bool store_value(V& value, std::string_view text)
+        {
+            if constexpr (std::is_floating_point<V>::value)
+            {
+                // convert has no long double overload
+                f64 real = 0.0;
+                if (convert::to_float(text, real) != CONVERT_OK)
+                {
+                    return false;
+                }
+                value = (V)real;
+                return true;
+            }
+            else
+            {
+                return convert::to_integer(text, value) == CONVERT_OK;
+            }
+        }
+
+        // Dispatch on the id without virtual calls: the fold expands to one
+        // comparison per option, each storing into its own member type
+        template<std::size_t... I>
+        bool store(i32 id, std::string_view text, S& values, std::index_sequence<I...>) const
+        {
+            bool stored = false;
+            ((id == (i32)I ? (stored = store_value(values.*(std::get<I>(this->options).member), text)) : false), ...);
+            return stored;
+        }
+
+        template<std::size_t... I>
+        constexpr std::string_view description(u64 id, std::index_sequence<I...>) const
+        {
+            std::string_view result;
+            ((id == I ? (result = std::get<I>(this->options).description, 0) : 0), ...);
+            return result;
+        }
+
+        constexpr u64 help_line_length(u64 id) const
+        {
+            u64 length = description(id, std::index_sequence_for<T...>()).size() + 1;
+            if (!this->short_names[id].empty())
+            {
+                length += this->short_names[id].size() + 3;
+            }
+            if (!this->names[id].empty())
+            {
+                length += this->names[id].size() + 2;
+            }
+            return length;
+        }
+
+        // option ids sorted by short name, then by long name
+        constexpr std::array<u64, sizeof...(T) + 1> help_order() const
+        {
+            std::array<u64, sizeof...(T) + 1> order{};
+            for (u64 n = 0; n < option_count; n++)
+            {
+                u64 id = n;
+                u64 at = n;
+                while (at > 0 && help_before(id, order[at - 1]))
+                {
+                    order[at] = order[at - 1];
+                    at--;
+                }
+                order[at] = id;
+            }
+            return order;
+        }
+
+        constexpr bool help_before(u64 a, u64 b) const
+        {
+            if (this->short_names[a] != this->short_names[b])
+            {
+                return this->short_names[a] < this->short_names[b];
+            }
+            return this->names[a] < this->names[b];
+        }
+
+        template<std::size_t L>
+        static constexpr u64 append(std::array<char, L>& text, u64 at, std::string_view part)
+        {
+            for (char c : part)
+            {
+                text[at++] = c;
+            }
+            return at;
+        }
+
+        std::tuple<schema_option<S, T>...> options;
+        std::array<std::string_view, sizeof...(T)> short_names;
+        std::array<std::string_view, sizeof...(T)> names;
+        perfect_table<sizeof...(T)> short_table;
+        perfect_table<sizeof...(T)> long_table;
+        std::array<bool, sizeof...(T)> takes_value;
+        std::array<bool, sizeof...(T)> numeric;
+    };
+
+    template<typename S, typename... T>
+    constexpr schema<S, T...> make_schema(schema_option<S, T>... specs)
+    {
+        return schema<S, T...>(specs...);
+    }
+}
+
+#endif
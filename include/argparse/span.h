@@ -0,0 +1,33 @@
+#ifndef ARGPARSE_SPAN_H
+#define ARGPARSE_SPAN_H
+
+#include "argparse/defs.h"
+
+namespace argparse
+{
+    // Non-owning view over a contiguous array, a small stand-in for C++20 std::span
+    template<typename T>
+    class span
+    {
+    public:
+        span() : items(nullptr), count(0) {}
+        span(T* items, u64 count) : items(items), count(count) {}
+        template<typename U>
+        span(const std::vector<U>& items) : items(items.data()), count(items.size()) {}
+        template<typename U>
+        span(std::vector<U>& items) : items(items.data()), count(items.size()) {}
+
+        T* data() const { return this->items; }
+        u64 size() const { return this->count; }
+        bool empty() const { return this->count == 0; }
+        T& operator[](u64 index) const { return this->items[index]; }
+        T* begin() const { return this->items; }
+        T* end() const { return this->items + this->count; }
+
+    private:
+        T* items;
+        u64 count;
+    };
+}
+
+#endif
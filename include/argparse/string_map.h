@@ -0,0 +1,53 @@
+#ifndef ARGPARSE_STRING_MAP_H
+#define ARGPARSE_STRING_MAP_H
+
+#include "argparse/defs.h"
+#include "argparse/span.h"
+
+namespace argparse
+{
+    // One definition of a map option, KEY=VALUE, with the hash of its key
+    struct map_entry
+    {
+        u64 hash;
+        std::string_view key;
+        std::string_view value;
+    };
+
+    // Read-only view of the definitions of a map option. Every key is stored
+    // once, in the order it was first defined, with the value it was given
+    // last; an open-addressing table of entry numbers, a power of two in
+    // size and at most half full, finds a key with one hash and linear
+    // probing. Keys and values point into the parsed tokens, or into the
+    // parser's copy of them after its own parse of a vector or argv.
+    class string_map
+    {
+    public:
+        string_map();
+        // slots holds capacity entry numbers, 1 based, 0 for a free slot
+        string_map(const map_entry* entries, u64 count, const u32* slots, u64 capacity);
+
+        u64 size() const;
+        bool empty() const;
+
+        // Value defined for key, or nullptr if it is not defined
+        const std::string_view* find(std::string_view key) const;
+        bool contains(std::string_view key) const;
+        // Value defined for key, or fallback
+        std::string_view get(std::string_view key, std::string_view fallback = std::string_view()) const;
+
+        // Definitions in the order their keys were first defined
+        span<const map_entry> entries() const;
+
+        // FNV-1a, as used for option names
+        static u64 hash(std::string_view key);
+
+    private:
+        const map_entry* items;
+        u64 count;
+        const u32* slots;
+        u64 capacity;
+    };
+}
+
+#endif
\ No newline at end of file
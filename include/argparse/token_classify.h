@@ -0,0 +1,26 @@
+#ifndef ARGPARSE_TOKEN_CLASSIFY_H
+#define ARGPARSE_TOKEN_CLASSIFY_H
+
+#include "argparse/defs.h"
+
+namespace argparse
+{
+    // What a command line token looks like, from its leading dashes
+    enum token_kind
+    {
+        TOKEN_POSITIONAL,   // no leading dash, empty, or a lone -
+        TOKEN_SHORT,        // -x, -xyz
+        TOKEN_LONG,         // --name
+        TOKEN_LONG_VALUE,   // --name=value
+        TOKEN_TERMINATOR    // --
+    };
+
+    // Kind of a single token, setting separator for TOKEN_LONG_VALUE
+    token_kind classify_token(std::string_view token, u32& separator);
+
+    // Whether a TOKEN_SHORT token reads as a negative number, "-5", "-0.5" or
+    // "-.5", which a numeric option takes as its value
+    bool is_negative_number(std::string_view token);
+}
+
+#endif
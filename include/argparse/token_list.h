@@ -0,0 +1,40 @@
+#ifndef ARGPARSE_TOKEN_LIST_H
+#define ARGPARSE_TOKEN_LIST_H
+
+#include "argparse/defs.h"
+#include "argparse/span.h"
+
+namespace argparse
+{
+    // Read-only view over a list of command line tokens. The tokens are never
+    // copied: every access returns a string_view into the caller's storage,
+    // which must outlive the token_list.
+    class token_list
+    {
+    public:
+        token_list(int argc, const char* const* argv);
+        token_list(const std::vector<std::string>& args);
+        token_list(span<const std::string_view> args);
+        // Tokens of one buffer, each ended by delimiter as in /proc/<pid>/cmdline.
+        // The last token need not be. Tokens are found by walking the buffer,
+        // which is cheap for the in-order access of a parse.
+        token_list(std::string_view buffer, char delimiter);
+
+        u64 size() const;
+        std::string_view operator[](u64 index) const;
+
+
+    private:
+        const char* const* argv;
+        const std::string* strings;
+        const std::string_view* views;
+        std::string_view buffer;
+        char delimiter;
+        u64 count;
+        // start of token cursor_index in buffer, kept from the last access
+        mutable u64 cursor_index;
+        mutable u64 cursor_offset;
+    };
+}
+
+#endif
@@ -0,0 +1,42 @@
+#ifndef ARGPARSE_TOKEN_STREAM_H
+#define ARGPARSE_TOKEN_STREAM_H
+
+#include "argparse/defs.h"
+
+namespace argparse
+{
+    // Reads delimited tokens from a file descriptor or an std::istream in large
+    // chunks, such as the NUL separated output of find -print0 or one argument
+    // per line. Only the current chunk is held, grown when a single token does
+    // not fit, so memory does not depend on the length of the stream.
+    class token_stream
+    {
+    public:
+        token_stream(int fd, char delimiter = '\0', u64 chunk_size = 64 * 1024, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+        token_stream(std::istream& in, char delimiter = '\0', u64 chunk_size = 64 * 1024, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+        // Next token, valid until the following call. A final token need not
+        // end with the delimiter. Returns false at the end of the input.
+        bool next(std::string_view& token);
+
+        // Whether reading stopped on an error rather than at the end
+        bool failed() const;
+
+    private:
+        void fill();
+
+        int fd;
+        std::istream* in;
+        char delimiter;
+        std::pmr::vector<char> buffer;
+        // unread tokens are buffer[begin, end); the delimiter search has
+        // already covered up to scan
+        u64 begin;
+        u64 scan;
+        u64 end;
+        bool at_end;
+        bool read_failed;
+    };
+}
+
+#endif
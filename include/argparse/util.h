@@ -9,13 +9,27 @@
 #include "argparse/parameter_integer.h"
 #include "argparse/parameter_string.h"
 #include "argparse/parameter_float.h"
+#include "argparse/parameter_string_list.h"
+#include "argparse/parameter_integer_list.h"
+#include "argparse/parameter_float_list.h"
+#include "argparse/parameter_string_map.h"
+#include "argparse/parameter_flag_set.h"
 
 namespace argparse
 {
     class util
     {
     public:
-        static parameter* create_parameter(std::string short_name, std::string name, std::string description, parameter_type type=parameter_type::NONE);
+        static parameter* create_parameter(std::string_view short_name, std::string_view name, std::string_view description, parameter_type type=parameter_type::NONE);
+
+        // Construct a parameter, its names and description in memory from resource;
+        // it must be released with destroy_parameter on the same resource
+        static parameter* create_parameter(std::string_view short_name, std::string_view name, std::string_view description, parameter_type type, std::pmr::memory_resource* resource);
+        static void destroy_parameter(parameter* p_parameter, std::pmr::memory_resource* resource);
+
+        // Append a token to an error message, cut to its first 80 bytes and
+        // "..." when it is longer, so that a huge value is not copied whole
+        static void append_value(std::string& message, std::string_view value);
     };
 }
 
@@ -0,0 +1,94 @@
+#ifndef ARGPARSE_VALUE_TABLE_H
+#define ARGPARSE_VALUE_TABLE_H
+
+#include "argparse/defs.h"
+#include "argparse/parameter.h"
+
+namespace argparse
+{
+    // Values of a list option, a run of value_table::items, integer_items or
+    // real_items. For a map option, the offset of its block of map_slots and
+    // the number of distinct keys. For a flag family, the offset of its words
+    // in flag_words and the number of flags.
+    struct value_range
+    {
+        u32 offset;
+        u32 count;
+    };
+
+    // Value of one option; the member in use follows from the option's type
+    union value_cell
+    {
+        i64 integer;
+        f64 real;
+        bool flag;
+        value_range range;
+    };
+
+    // Values of every option of a parse as a structure of arrays, addressed by
+    // option id: a state byte, an 8 byte cell and a text view per option. The
+    // text of a STRING option points into the parsed tokens, as does the text
+    // of a deferred value until it is converted. The values of a list option
+    // are a range of one of the item arrays, where every option's values are
+    // packed back to back: views into the tokens for STRING_LIST, numbers for
+    // INTEGER_LIST and FLOAT_LIST. A STRING_MAP option's definitions are a run
+    // of map_entries, one per key, found through a block of map_slots: the
+    // index of the first entry, the capacity of the hash table, then the
+    // table of 1 based entry numbers. A FLAG_SET option's flags are bits of
+    // a run of flag_words.
+    //
+    // A parse starts from a copy of the defaults and records the entries it
+    // changes in touched, so the next parse restores only those instead of
+    // copying every option again; the item arrays only grow during a parse,
+    // and are cut back to the defaults' length.
+    struct value_table
+    {
+        // bits of states
+        static constexpr u8 PRESENT = 1;   // given on the command line
+        static constexpr u8 DEFERRED = 2;  // only the text is set, see parser::convert_deferred
+        static constexpr u8 TOUCHED = 4;   // listed in touched
+
+        value_table(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+        u64 size() const;
+        // Append an empty entry for a new option
+        void push_back();
+        // Clear the entry of an option
+        void reset(i32 id);
+        // Copy every entry of other, reusing this table's memory
+        void assign(const value_table& other);
+        // Record that the entry of an option is about to change
+        void touch(i32 id);
+        // Same as assign(other) for a table that was assigned from other and
+        // has changed only through touched entries and appended items since
+        void restore(const value_table& other);
+
+        // Convert between an entry and the value_slot that parameters exchange
+        value_slot get_slot(i32 id, parameter_type type) const;
+        void set_slot(i32 id, parameter_type type, const value_slot& slot);
+
+        // Start the map of an option with room for count definitions
+        void begin_map(i32 id, u64 count);
+        // Define key in a map started by begin_map, replacing an earlier value
+        // of the same key
+        void define(i32 id, std::string_view key, std::string_view value);
+        // View of the map of an option, valid until this table changes
+        string_map map(i32 id) const;
+        // View of the flags of a flag family
+        flag_set flags(i32 id) const;
+
+        std::pmr::vector<u8> states;
+        std::pmr::vector<value_cell> cells;
+        std::pmr::vector<std::string_view> texts;
+        std::pmr::vector<std::string_view> items;
+        std::pmr::vector<i64> integer_items;
+        std::pmr::vector<f64> real_items;
+        std::pmr::vector<map_entry> map_entries;
+        std::pmr::vector<u32> map_slots;
+        std::pmr::vector<u64> flag_words;
+        // ids of the entries changed since the last assign or restore
+        std::pmr::vector<i32> touched;
+    };
+}
+
+#endif
@@ -0,0 +1,287 @@
+#include "argparse/batch.h"
+#include "argparse/parser.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <utility>
+
+using namespace argparse;
+
+batch_result::batch_result()
+{
+}
+
+u64 batch_result::size() const
+{
+    return this->row_succeeded.size();
+}
+
+u64 batch_result::get_failure_count() const
+{
+    return this->error_rows.size();
+}
+
+bool batch_result::succeeded(u64 row) const
+{
+    return this->row_succeeded[row] != 0;
+}
+
+std::string_view batch_result::get_error(u64 row) const
+{
+    auto it = std::lower_bound(this->error_rows.begin(), this->error_rows.end(), row);
+    if (it == this->error_rows.end() || *it != row)
+    {
+        return std::string_view();
+    }
+    u64 i = it - this->error_rows.begin();
+    u64 begin = this->error_offsets[i];
+    return std::string_view(this->error_text).substr(begin, this->error_offsets[i + 1] - begin);
+}
+
+span<const u8> batch_result::column_values(i32 id, u8*) const
+{
+    return this->columns[id].flags;
+}
+
+span<const i64> batch_result::column_values(i32 id, i64*) const
+{
+    return this->columns[id].integers;
+}
+
+span<const f64> batch_result::column_values(i32 id, f64*) const
+{
+    return this->columns[id].reals;
+}
+
+span<const std::string_view> batch_result::column_values(i32 id, std::string_view*) const
+{
+    return this->columns[id].texts;
+}
+
+namespace
+{
+    // Rows still to be parsed by one worker, packed into one atomic word so
+    // the owner and thieves agree on it: next row in the low 32 bits, end in
+    // the high 32 bits. The owner takes chunks from the front, thieves take
+    // the back half.
+    struct work_range
+    {
+        std::atomic<u64> bounds;
+    };
+
+    const u64 BATCH_CHUNK = 64;
+    const u64 BATCH_BLOCK = 0xffffffffull;
+
+    u64 pack_range(u64 next, u64 end)
+    {
+        return (end << 32) | next;
+    }
+
+    bool take_chunk(work_range& range, u64& begin, u64& end)
+    {
+        u64 bounds = range.bounds.load();
+        while (true)
+        {
+            u64 next = bounds & 0xffffffffull;
+            u64 last = bounds >> 32;
+            if (next >= last)
+            {
+                return false;
+            }
+            u64 count = std::min(BATCH_CHUNK, last - next);
+            if (range.bounds.compare_exchange_weak(bounds, pack_range(next + count, last)))
+            {
+                begin = next;
+                end = next + count;
+                return true;
+            }
+        }
+    }
+
+    bool steal_half(work_range& victim, work_range& thief)
+    {
+        u64 bounds = victim.bounds.load();
+        while (true)
+        {
+            u64 next = bounds & 0xffffffffull;
+            u64 last = bounds >> 32;
+            if (next >= last)
+            {
+                return false;
+            }
+            u64 middle = next + (last - next) / 2;
+            if (victim.bounds.compare_exchange_weak(bounds, pack_range(next, middle)))
+            {
+                // the thief's own range is empty, so nobody else writes it now
+                thief.bounds.store(pack_range(middle, last));
+                return true;
+            }
+        }
+    }
+
+    struct batch_error
+    {
+        u64 row;
+        std::string message;
+    };
+}
+
+bool parser::parse_batch(span<const arg_vector> inputs, batch_result& results, u32 thread_count) const
+{
+    return parse_rows(inputs.size(), [&](u64 row)
+    {
+        return token_list(inputs[row].argc, inputs[row].argv);
+    }, results, thread_count);
+}
+
+bool parser::parse_batch(const process_scan& processes, batch_result& results, u32 thread_count) const
+{
+    return parse_rows(processes.size(), [&](u64 row)
+    {
+        return token_list(processes.get_cmdline(row), '\0');
+    }, results, thread_count);
+}
+
+bool parser::parse_rows(u64 rows, const std::function<token_list(u64)>& row_tokens, batch_result& results, u32 thread_count) const
+{
+    u64 option_count = this->parameters.size();
+    convert_defaults();
+
+    results.columns.resize(option_count);
+    for (u64 id = 0; id < option_count; id++)
+    {
+        batch_result::column_data& column = results.columns[id];
+        parameter_type type = (parameter_type)this->types[id];
+        column.flags.resize(type == NONE ? rows : 0);
+        column.integers.resize(type == INTEGER ? rows : 0);
+        column.reals.resize(type == FLOAT ? rows : 0);
+        column.texts.resize(type == STRING ? rows : 0);
+        column.present.resize(rows);
+    }
+    results.row_succeeded.resize(rows);
+    results.error_rows.clear();
+    results.error_offsets.clear();
+    results.error_text.clear();
+
+    if (thread_count == 0)
+    {
+        thread_count = std::max(1u, std::thread::hardware_concurrency());
+    }
+    thread_count = (u32)std::max<u64>(1, std::min<u64>(thread_count, (rows + BATCH_CHUNK - 1) / BATCH_CHUNK));
+
+    std::unique_ptr<work_range[]> ranges(new work_range[thread_count]);
+    std::vector<std::vector<batch_error>> errors(thread_count);
+
+    auto store_row = [&](u64 row, const parse_result& result, bool succeeded)
+    {
+        const value_table& values = succeeded ? result.values : this->defaults;
+        for (u64 id = 0; id < option_count; id++)
+        {
+            batch_result::column_data& column = results.columns[id];
+            switch (this->types[id])
+            {
+            case NONE:
+                column.flags[row] = values.cells[id].flag;
+                break;
+            case INTEGER:
+                column.integers[row] = values.cells[id].integer;
+                break;
+            case FLOAT:
+                column.reals[row] = values.cells[id].real;
+                break;
+            case STRING:
+                column.texts[row] = values.texts[id];
+                break;
+            case STRING_LIST:
+            case INTEGER_LIST:
+            case FLOAT_LIST:
+            case STRING_MAP:
+            case FLAG_SET:
+                // lists, maps and flag families have no column, only their
+                // presence is recorded
+                break;
+            }
+            column.present[row] = values.states[id] & value_table::PRESENT;
+        }
+        results.row_succeeded[row] = succeeded;
+    };
+
+    // parse the rows of one block; ranges are relative to the block
+    auto work = [&](u32 worker, u64 block)
+    {
+        parse_result result;
+        u64 begin = 0;
+        u64 end = 0;
+        while (true)
+        {
+            if (!take_chunk(ranges[worker], begin, end))
+            {
+                bool stolen = false;
+                for (u32 k = 1; k < thread_count && !stolen; k++)
+                {
+                    stolen = steal_half(ranges[(worker + k) % thread_count], ranges[worker]);
+                }
+                if (!stolen)
+                {
+                    return;
+                }
+                continue;
+            }
+            for (u64 row = block + begin; row < block + end; row++)
+            {
+                bool succeeded = parse_tokens(row_tokens(row), result, false);
+                if (!succeeded)
+                {
+                    errors[worker].push_back(batch_error{row, result.error});
+                }
+                store_row(row, result, succeeded);
+            }
+        }
+    };
+
+    // rows are handed out in blocks that fit the 32 bit packed ranges
+    for (u64 block = 0; block < rows; block += BATCH_BLOCK)
+    {
+        u64 block_rows = std::min(BATCH_BLOCK, rows - block);
+        for (u32 worker = 0; worker < thread_count; worker++)
+        {
+            u64 next = block_rows * worker / thread_count;
+            u64 last = block_rows * (worker + 1) / thread_count;
+            ranges[worker].bounds.store(pack_range(next, last));
+        }
+
+        std::vector<std::thread> threads;
+        for (u32 worker = 1; worker < thread_count; worker++)
+        {
+            threads.emplace_back(work, worker, block);
+        }
+        work(0, block);
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+    }
+
+    // gather the errors of all workers in row order
+    std::vector<batch_error> all_errors;
+    for (auto& worker_errors : errors)
+    {
+        for (auto& error : worker_errors)
+        {
+            all_errors.push_back(std::move(error));
+        }
+    }
+    std::sort(all_errors.begin(), all_errors.end(), [](const batch_error& a, const batch_error& b)
+    {
+        return a.row < b.row;
+    });
+    results.error_offsets.push_back(0);
+    for (const batch_error& error : all_errors)
+    {
+        results.error_rows.push_back(error.row);
+        results.error_text += error.message;
+        results.error_offsets.push_back(results.error_text.size());
+    }
+    return all_errors.empty();
+}
@@ -0,0 +1,239 @@
+#include "argparse/convert.h"
+#include <cstring>
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+using namespace argparse;
+
+template<typename T>
+static convert_status float_from_chars(std::string_view text, T& value)
+{
+    // from_chars does not take a leading plus sign
+    if (!text.empty() && text[0] == '+')
+    {
+        text.remove_prefix(1);
+        if (text.empty() || text[0] == '-')
+        {
+            return CONVERT_INVALID;
+        }
+    }
+    T result_value = 0;
+    auto result = std::from_chars(text.data(), text.data() + text.size(), result_value, std::chars_format::general);
+    if (result.ec == std::errc::invalid_argument || result.ptr != text.data() + text.size())
+    {
+        return CONVERT_INVALID;
+    }
+    if (result.ec == std::errc::result_out_of_range)
+    {
+        return CONVERT_OUT_OF_RANGE;
+    }
+    value = result_value;
+    return CONVERT_OK;
+}
+
+convert_status convert::to_float(std::string_view text, f64& value)
+{
+    return float_from_chars(text, value);
+}
+
+convert_status convert::to_float(std::string_view text, f32& value)
+{
+    return float_from_chars(text, value);
+}
+
+// Call field with every separated field of text, the separators located one
+// vector block at a time, until it returns false
+template<typename F>
+static void for_each_field(std::string_view text, char separator, F field)
+{
+    const char* data = text.data();
+    u64 size = text.size();
+    u64 start = 0;
+    u64 at = 0;
+#if defined(__AVX2__)
+    const __m256i separators = _mm256_set1_epi8(separator);
+    for (; at + 32 <= size; at += 32)
+    {
+        u32 mask = (u32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(data + at)), separators));
+        for (; mask != 0; mask &= mask - 1)
+        {
+            u64 end = at + (u64)__builtin_ctz(mask);
+            if (!field(std::string_view(data + start, end - start)))
+            {
+                return;
+            }
+            start = end + 1;
+        }
+    }
+#elif defined(__SSE2__)
+    const __m128i separators = _mm_set1_epi8(separator);
+    for (; at + 16 <= size; at += 16)
+    {
+        u32 mask = (u32)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(data + at)), separators));
+        for (; mask != 0; mask &= mask - 1)
+        {
+            u64 end = at + (u64)__builtin_ctz(mask);
+            if (!field(std::string_view(data + start, end - start)))
+            {
+                return;
+            }
+            start = end + 1;
+        }
+    }
+#endif
+    for (; at < size; at++)
+    {
+        if (data[at] == separator)
+        {
+            if (!field(std::string_view(data + start, at - start)))
+            {
+                return;
+            }
+            start = at + 1;
+        }
+    }
+    field(std::string_view(data + start, size - start));
+}
+
+// Decimal integer of 1 to 16 digits with an optional minus sign, converted 8
+// digits at a time within one 64 bit word. Anything else, which cannot
+// overflow here, is left to convert::to_integer.
+static bool decimal_from_words(std::string_view text, i64& value)
+{
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    bool negative = !text.empty() && text[0] == '-';
+    if (negative)
+    {
+        text.remove_prefix(1);
+    }
+    if (text.empty() || text.size() > 16)
+    {
+        return false;
+    }
+    u64 result = 0;
+    u64 at = 0;
+    while (at < text.size())
+    {
+        // the first word takes the odd digits, padded with leading zeros
+        u64 length = at == 0 ? (text.size() - 1) % 8 + 1 : 8;
+        u64 word = 0x3030303030303030ull;
+        std::memcpy((char*)&word + (8 - length), text.data() + at, length);
+        if (((word & 0xF0F0F0F0F0F0F0F0ull) | (((word + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull) >> 4)) != 0x3333333333333333ull)
+        {
+            return false;
+        }
+        word -= 0x3030303030303030ull;
+        word = word * 10 + (word >> 8);
+        word = (((word & 0x000000FF000000FFull) * (100 + (1000000ull << 32))) + (((word >> 16) & 0x000000FF000000FFull) * (1 + (10000ull << 32)))) >> 32;
+        result = result * 100000000ull + word;
+        at += length;
+    }
+    value = negative ? -(i64)result : (i64)result;
+    return true;
+#else
+    return false;
+#endif
+}
+
+convert_status convert::to_integers(std::string_view text, char separator, std::pmr::vector<i64>& values, std::string_view* field)
+{
+    u64 original = values.size();
+    convert_status status = CONVERT_OK;
+    if (text.empty())
+    {
+        return status;
+    }
+    for_each_field(text, separator, [&](std::string_view piece)
+    {
+        i64 value = 0;
+        if (!decimal_from_words(piece, value))
+        {
+            status = to_integer(piece, value);
+            if (status != CONVERT_OK)
+            {
+                if (field != nullptr)
+                {
+                    *field = piece;
+                }
+                return false;
+            }
+        }
+        values.push_back(value);
+        return true;
+    });
+    if (status != CONVERT_OK)
+    {
+        values.resize(original);
+    }
+    return status;
+}
+
+convert_status convert::to_floats(std::string_view text, char separator, std::pmr::vector<f64>& values, std::string_view* field)
+{
+    u64 original = values.size();
+    convert_status status = CONVERT_OK;
+    if (text.empty())
+    {
+        return status;
+    }
+    for_each_field(text, separator, [&](std::string_view piece)
+    {
+        f64 value = 0.0;
+        status = float_from_chars(piece, value);
+        if (status != CONVERT_OK)
+        {
+            if (field != nullptr)
+            {
+                *field = piece;
+            }
+            return false;
+        }
+        values.push_back(value);
+        return true;
+    });
+    if (status != CONVERT_OK)
+    {
+        values.resize(original);
+    }
+    return status;
+}
+
+const char* convert::describe(convert_status status)
+{
+    switch (status)
+    {
+    case CONVERT_OK:
+        return "ok";
+    case CONVERT_INVALID:
+        return "invalid number";
+    case CONVERT_OUT_OF_RANGE:
+        return "number out of range";
+    default:
+        return "unknown conversion status";
+    }
+}
+
+int convert::strip_base_prefix(std::string_view& text, int base)
+{
+    bool hex_prefix = text.size() > 2 && text[0] == '0' && (text[1] == 'x' || text[1] == 'X');
+    if (base == 0)
+    {
+        if (hex_prefix)
+        {
+            text.remove_prefix(2);
+            return 16;
+        }
+        if (text.size() > 1 && text[0] == '0')
+        {
+            text.remove_prefix(1);
+            return 8;
+        }
+        return 10;
+    }
+    if (base == 16 && hex_prefix)
+    {
+        text.remove_prefix(2);
+    }
+    return base;
+}
@@ -0,0 +1,40 @@
+#include "argparse/flag_set.h"
+
+using namespace argparse;
+
+flag_set::flag_set() : bits(nullptr), flags(0)
+{
+}
+
+flag_set::flag_set(const u64* words, u64 count) : bits(words), flags(count)
+{
+}
+
+u64 flag_set::size() const
+{
+    return this->flags;
+}
+
+bool flag_set::test(i32 flag) const
+{
+    if (flag < 0 || (u64)flag >= this->flags)
+    {
+        return false;
+    }
+    return (this->bits[flag / 64] >> (flag % 64)) & 1;
+}
+
+u64 flag_set::count() const
+{
+    u64 enabled = 0;
+    for (u64 word : words())
+    {
+        enabled += (u64)__builtin_popcountll(word);
+    }
+    return enabled;
+}
+
+span<const u64> flag_set::words() const
+{
+    return span<const u64>(this->bits, (this->flags + 63) / 64);
+}
\ No newline at end of file
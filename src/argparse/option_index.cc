@@ -0,0 +1,132 @@
+#include "argparse/option_index.h"
+#include "argparse/hash.h"
+
+using namespace argparse;
+
+option_index::option_index(std::pmr::memory_resource* resource) : short_names(resource), names(resource)
+{
+    clear();
+}
+
+void option_index::add_short(std::string_view short_name, i32 id)
+{
+    if (short_name.size() == 1)
+    {
+        this->short_table[(u8)short_name[0]] = id;
+    }
+    else
+    {
+        this->short_names.insert(short_name, id);
+    }
+}
+
+void option_index::add_long(std::string_view name, i32 id)
+{
+    this->names.insert(name, id);
+}
+
+void option_index::clear()
+{
+    for (auto& entry : this->short_table)
+    {
+        entry = -1;
+    }
+    this->short_names.clear();
+    this->names.clear();
+}
+
+i32 option_index::find_short(std::string_view short_name) const
+{
+    if (short_name.size() == 1)
+    {
+        return this->short_table[(u8)short_name[0]];
+    }
+    return this->short_names.find(short_name);
+}
+
+i32 option_index::find_long(std::string_view name) const
+{
+    return this->names.find(name);
+}
+
+u64 option_index::hash(std::string_view name)
+{
+    return fnv1a(name);
+}
+
+option_index::table::table(std::pmr::memory_resource* resource) : slots(resource)
+{
+    this->count = 0;
+}
+
+void option_index::table::insert(std::string_view name, i32 id)
+{
+    if ((this->count + 1) * 2 > this->slots.size())
+    {
+        grow();
+    }
+    u64 h = hash(name);
+    u64 mask = this->slots.size() - 1;
+    for (u64 i = h & mask; ; i = (i + 1) & mask)
+    {
+        slot& s = this->slots[i];
+        if (s.id < 0)
+        {
+            s.hash = h;
+            s.name = name;
+            s.id = id;
+            this->count++;
+            return;
+        }
+        if (s.hash == h && s.name == name)
+        {
+            // re-registering a name points it at the newest option
+            s.name = name;
+            s.id = id;
+            return;
+        }
+    }
+}
+
+i32 option_index::table::find(std::string_view name) const
+{
+    if (this->count == 0)
+    {
+        return -1;
+    }
+    u64 h = hash(name);
+    u64 mask = this->slots.size() - 1;
+    for (u64 i = h & mask; ; i = (i + 1) & mask)
+    {
+        const slot& s = this->slots[i];
+        if (s.id < 0)
+        {
+            return -1;
+        }
+        if (s.hash == h && s.name == name)
+        {
+            return s.id;
+        }
+    }
+}
+
+void option_index::table::clear()
+{
+    this->slots.clear();
+    this->count = 0;
+}
+
+void option_index::table::grow()
+{
+    std::pmr::vector<slot> old(this->slots.get_allocator());
+    old.swap(this->slots);
+    this->slots.assign(old.empty() ? 16 : old.size() * 2, slot{0, std::string_view(), -1});
+    this->count = 0;
+    for (const slot& s : old)
+    {
+        if (s.id >= 0)
+        {
+            insert(s.name, s.id);
+        }
+    }
+}
@@ -2,11 +2,9 @@
 
 using namespace argparse;
 
-parameter::parameter(std::string short_name, std::string name, std::string description, parameter_type type)
+parameter::parameter(std::string_view short_name, std::string_view name, std::string_view description, parameter_type type, std::pmr::memory_resource* resource)
+    : short_name(short_name, resource), name(name, resource), description(description, resource), default_text(resource)
 {
-    this->short_name = short_name;
-    this->name = name;
-    this->description = description;
     this->type = type;
     this->required = false; // Initialize required field
 }
@@ -15,40 +13,59 @@ parameter::~parameter()
 {
 }
 
-std::string parameter::get_short_name()
+std::string_view parameter::get_short_name() const
 {
     return this->short_name;
 }
 
-std::string parameter::get_name()
+std::string_view parameter::get_name() const
 {
     return this->name;
 }
 
-std::string parameter::get_description()
+std::string_view parameter::get_description() const
 {
     return this->description;
 }
 
-void parameter::set(std::string value)
+bool parameter::set(std::string_view /*value*/)
 {
+    return true;
 }
 
 void parameter::get_value_to(void* p_value)
 {
 }
 
+void parameter::assign(const value_slot& /*slot*/)
+{
+}
+
+void parameter::capture_default(value_slot& /*slot*/)
+{
+}
+
 void parameter::set_required(bool required)
 {
     this->required = required;
 }
 
-bool parameter::get_required()
+bool parameter::get_required() const
 {
     return this->required;
 }
 
-parameter_type parameter::get_type()
+void parameter::set_default_text(std::string_view text)
+{
+    this->default_text.assign(text.data(), text.size());
+}
+
+std::string_view parameter::get_default_text() const
+{
+    return this->default_text;
+}
+
+parameter_type parameter::get_type() const
 {
     return this->type;
 }
\ No newline at end of file
@@ -0,0 +1,97 @@
+#include "argparse/parameter_flag_set.h"
+#include <cstring>
+
+using namespace argparse;
+
+parameter_flag_set::parameter_flag_set(std::string_view short_name, std::string_view name, std::string_view description, std::pmr::memory_resource* resource)
+    : parameter(short_name, name, description, FLAG_SET, resource), enable_prefix(resource), disable_prefix(resource), names_memory(resource), names(resource), default_words(resource), count(0)
+{
+}
+
+parameter_flag_set::~parameter_flag_set()
+{
+}
+
+void parameter_flag_set::get_value_to(void* p_value)
+{
+    *(flag_set*)p_value = this->value;
+}
+
+const flag_set& parameter_flag_set::get_value() const
+{
+    return this->value;
+}
+
+void parameter_flag_set::assign(const value_slot& slot)
+{
+    this->value = slot.flags;
+}
+
+void parameter_flag_set::capture_default(value_slot& slot)
+{
+    slot.flags = flag_set(this->default_words.data(), (u64)this->count);
+}
+
+void parameter_flag_set::set_prefixes(std::string_view enable, std::string_view disable)
+{
+    this->enable_prefix.assign(enable.data(), enable.size());
+    this->disable_prefix.assign(disable.data(), disable.size());
+}
+
+std::string_view parameter_flag_set::get_enable_prefix() const
+{
+    return this->enable_prefix;
+}
+
+std::string_view parameter_flag_set::get_disable_prefix() const
+{
+    return this->disable_prefix;
+}
+
+i32 parameter_flag_set::add_flag(std::string_view name, bool enabled)
+{
+    if (name.empty() || this->names.find_long(name) >= 0)
+    {
+        return -1;
+    }
+    char* copy = (char*)this->names_memory.allocate(name.size(), 1);
+    std::memcpy(copy, name.data(), name.size());
+    i32 flag = this->count++;
+    this->names.add_long(std::string_view(copy, name.size()), flag);
+    if (flag % 64 == 0)
+    {
+        this->default_words.push_back(0);
+    }
+    this->default_words.back() |= (u64)enabled << (flag % 64);
+    // the stateful value before the first parse
+    this->value = flag_set(this->default_words.data(), (u64)this->count);
+    return flag;
+}
+
+i32 parameter_flag_set::find_flag(std::string_view name) const
+{
+    return this->names.find_long(name);
+}
+
+i32 parameter_flag_set::match(std::string_view token, bool& enabled) const
+{
+    // the disable prefix usually extends the enable prefix, as -fno- does -f,
+    // so it is tried first; a flag named like no-name is still found after
+    std::string_view disable = this->disable_prefix;
+    if (token.size() > disable.size() && token.substr(0, disable.size()) == disable)
+    {
+        i32 flag = this->names.find_long(token.substr(disable.size()));
+        if (flag >= 0)
+        {
+            enabled = false;
+            return flag;
+        }
+    }
+    std::string_view enable = this->enable_prefix;
+    if (token.size() > enable.size() && token.substr(0, enable.size()) == enable)
+    {
+        enabled = true;
+        return this->names.find_long(token.substr(enable.size()));
+    }
+    return -1;
+}
\ No newline at end of file
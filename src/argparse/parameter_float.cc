@@ -1,22 +1,44 @@
 #include "argparse/parameter_float.h"
+#include "argparse/convert.h"
 
 using namespace argparse;
 
-parameter_float::parameter_float(std::string short_name, std::string name, std::string description) : parameter(short_name, name, description, FLOAT)
+parameter_float::parameter_float(std::string_view short_name, std::string_view name, std::string_view description, std::pmr::memory_resource* resource) : parameter(short_name, name, description, FLOAT, resource)
 {
     this->value = 0.0;
+    this->target = &this->value;
 }
 
 parameter_float::~parameter_float()
 {
 }
 
-void parameter_float::set(std::string value)
+bool parameter_float::set(std::string_view value)
 {
-    this->value = std::stod(value);
+    return convert::to_float(value, *this->target) == CONVERT_OK;
 }
 
 void parameter_float::get_value_to(void* p_value)
 {
-    *(f64*)p_value = this->value;
+    *(f64*)p_value = *this->target;
+}
+
+const f64& parameter_float::get_value() const
+{
+    return *this->target;
+}
+
+void parameter_float::bind(f64* target)
+{
+    this->target = target;
+}
+
+void parameter_float::assign(const value_slot& slot)
+{
+    *this->target = slot.real;
+}
+
+void parameter_float::capture_default(value_slot& slot)
+{
+    slot.real = *this->target;
 }
\ No newline at end of file
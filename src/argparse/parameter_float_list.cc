@@ -0,0 +1,50 @@
+#include "argparse/parameter_float_list.h"
+#include "argparse/convert.h"
+
+using namespace argparse;
+
+parameter_float_list::parameter_float_list(std::string_view short_name, std::string_view name, std::string_view description, std::pmr::memory_resource* resource) : parameter(short_name, name, description, FLOAT_LIST, resource), default_value(resource)
+{
+    this->target = &this->value;
+}
+
+parameter_float_list::~parameter_float_list()
+{
+}
+
+bool parameter_float_list::set(std::string_view value)
+{
+    std::pmr::vector<f64> values;
+    if (convert::to_floats(value, ',', values) != CONVERT_OK)
+    {
+        return false;
+    }
+    this->target->insert(this->target->end(), values.begin(), values.end());
+    return true;
+}
+
+void parameter_float_list::get_value_to(void* p_value)
+{
+    *(std::vector<f64>*)p_value = *this->target;
+}
+
+const std::vector<f64>& parameter_float_list::get_value() const
+{
+    return *this->target;
+}
+
+void parameter_float_list::bind(std::vector<f64>* target)
+{
+    this->target = target;
+}
+
+void parameter_float_list::assign(const value_slot& slot)
+{
+    this->target->assign(slot.reals.begin(), slot.reals.end());
+}
+
+void parameter_float_list::capture_default(value_slot& slot)
+{
+    this->default_value.assign(this->target->begin(), this->target->end());
+    slot.reals = span<const f64>(this->default_value.data(), this->default_value.size());
+}
\ No newline at end of file
@@ -1,11 +1,13 @@
 #include "argparse/parameter_integer.h"
+#include "argparse/convert.h"
 
 using namespace argparse;
 
-parameter_integer::parameter_integer(std::string short_name, std::string name, std::string description, int base, bool is_signed) : parameter(short_name, name, description, INTEGER)
+parameter_integer::parameter_integer(std::string_view short_name, std::string_view name, std::string_view description, int base, bool is_signed, std::pmr::memory_resource* resource) : parameter(short_name, name, description, INTEGER, resource)
 {
     this->base = base;
     this->value = 0;
+    this->target = &this->value;
     this->is_signed = is_signed;
 }
 
@@ -13,19 +15,52 @@ parameter_integer::~parameter_integer()
 {
 }
 
-void parameter_integer::set(std::string value)
+bool parameter_integer::set(std::string_view value)
 {
     if (this->is_signed)
     {
-        this->value = std::stoll(value, nullptr, this->base);
+        return convert::to_integer(value, *this->target, this->base) == CONVERT_OK;
     }
-    else
+    u64 unsigned_value = 0;
+    if (convert::to_integer(value, unsigned_value, this->base) != CONVERT_OK)
     {
-        this->value = std::stoull(value, nullptr, this->base);
+        return false;
     }
+    *this->target = (i64)unsigned_value;
+    return true;
 }
 
 void parameter_integer::get_value_to(void* p_value)
 {
-    *(i64*)p_value = this->value;
+    *(i64*)p_value = *this->target;
 }
+
+const i64& parameter_integer::get_value() const
+{
+    return *this->target;
+}
+
+void parameter_integer::bind(i64* target)
+{
+    this->target = target;
+}
+
+int parameter_integer::get_base() const
+{
+    return this->base;
+}
+
+bool parameter_integer::get_signed() const
+{
+    return this->is_signed;
+}
+
+void parameter_integer::assign(const value_slot& slot)
+{
+    *this->target = slot.integer;
+}
+
+void parameter_integer::capture_default(value_slot& slot)
+{
+    slot.integer = *this->target;
+}
\ No newline at end of file
@@ -0,0 +1,50 @@
+#include "argparse/parameter_integer_list.h"
+#include "argparse/convert.h"
+
+using namespace argparse;
+
+parameter_integer_list::parameter_integer_list(std::string_view short_name, std::string_view name, std::string_view description, std::pmr::memory_resource* resource) : parameter(short_name, name, description, INTEGER_LIST, resource), default_value(resource)
+{
+    this->target = &this->value;
+}
+
+parameter_integer_list::~parameter_integer_list()
+{
+}
+
+bool parameter_integer_list::set(std::string_view value)
+{
+    std::pmr::vector<i64> values;
+    if (convert::to_integers(value, ',', values) != CONVERT_OK)
+    {
+        return false;
+    }
+    this->target->insert(this->target->end(), values.begin(), values.end());
+    return true;
+}
+
+void parameter_integer_list::get_value_to(void* p_value)
+{
+    *(std::vector<i64>*)p_value = *this->target;
+}
+
+const std::vector<i64>& parameter_integer_list::get_value() const
+{
+    return *this->target;
+}
+
+void parameter_integer_list::bind(std::vector<i64>* target)
+{
+    this->target = target;
+}
+
+void parameter_integer_list::assign(const value_slot& slot)
+{
+    this->target->assign(slot.integers.begin(), slot.integers.end());
+}
+
+void parameter_integer_list::capture_default(value_slot& slot)
+{
+    this->default_value.assign(this->target->begin(), this->target->end());
+    slot.integers = span<const i64>(this->default_value.data(), this->default_value.size());
+}
\ No newline at end of file
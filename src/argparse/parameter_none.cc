@@ -2,21 +2,43 @@
 
 using namespace argparse;
 
-parameter_none::parameter_none(std::string short_name, std::string name, std::string description) : parameter(short_name, name, description, NONE)
+parameter_none::parameter_none(std::string_view short_name, std::string_view name, std::string_view description, std::pmr::memory_resource* resource) : parameter(short_name, name, description, NONE, resource)
 {
     this->is_set = false;
+    this->target = &this->is_set;
 }
 
 parameter_none::~parameter_none()
 {
 }
 
-void parameter_none::set(std::string value)
+bool parameter_none::set(std::string_view /*value*/)
 {
-    this->is_set = true;
+    *this->target = true;
+    return true;
 }
 
 void parameter_none::get_value_to(void* p_value)
 {
-    *(bool*)p_value = this->is_set;
+    *(bool*)p_value = *this->target;
+}
+
+const bool& parameter_none::get_value() const
+{
+    return *this->target;
+}
+
+void parameter_none::bind(bool* target)
+{
+    this->target = target;
+}
+
+void parameter_none::assign(const value_slot& slot)
+{
+    *this->target = slot.flag;
+}
+
+void parameter_none::capture_default(value_slot& slot)
+{
+    slot.flag = *this->target;
 }
\ No newline at end of file
@@ -2,22 +2,44 @@
 
 using namespace argparse;
 
-parameter_string::parameter_string(std::string short_name, std::string name, std::string description) : parameter(short_name, name, description, STRING)
+parameter_string::parameter_string(std::string_view short_name, std::string_view name, std::string_view description, std::pmr::memory_resource* resource) : parameter(short_name, name, description, STRING, resource), default_value(resource)
 {
     this->value = "";
+    this->target = &this->value;
 }
 
 parameter_string::~parameter_string()
 {
 }
 
-void parameter_string::set(std::string value)
+bool parameter_string::set(std::string_view value)
 {
-    this->value = value;
+    this->target->assign(value.data(), value.size());
+    return true;
 }
 
 void parameter_string::get_value_to(void* p_value)
 {
-    *(std::string*)p_value = this->value;
+    *(std::string*)p_value = *this->target;
 }
 
+const std::string& parameter_string::get_value() const
+{
+    return *this->target;
+}
+
+void parameter_string::bind(std::string* target)
+{
+    this->target = target;
+}
+
+void parameter_string::assign(const value_slot& slot)
+{
+    this->target->assign(slot.text.data(), slot.text.size());
+}
+
+void parameter_string::capture_default(value_slot& slot)
+{
+    this->default_value = *this->target;
+    slot.text = this->default_value;
+}
\ No newline at end of file
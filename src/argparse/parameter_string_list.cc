@@ -0,0 +1,44 @@
+#include "argparse/parameter_string_list.h"
+
+using namespace argparse;
+
+parameter_string_list::parameter_string_list(std::string_view short_name, std::string_view name, std::string_view description, std::pmr::memory_resource* resource) : parameter(short_name, name, description, STRING_LIST, resource), default_value(resource)
+{
+    this->target = &this->value;
+}
+
+parameter_string_list::~parameter_string_list()
+{
+}
+
+bool parameter_string_list::set(std::string_view value)
+{
+    this->target->push_back(value);
+    return true;
+}
+
+void parameter_string_list::get_value_to(void* p_value)
+{
+    *(std::vector<std::string_view>*)p_value = *this->target;
+}
+
+const std::vector<std::string_view>& parameter_string_list::get_value() const
+{
+    return *this->target;
+}
+
+void parameter_string_list::bind(std::vector<std::string_view>* target)
+{
+    this->target = target;
+}
+
+void parameter_string_list::assign(const value_slot& slot)
+{
+    this->target->assign(slot.items.begin(), slot.items.end());
+}
+
+void parameter_string_list::capture_default(value_slot& slot)
+{
+    this->default_value.assign(this->target->begin(), this->target->end());
+    slot.items = span<const std::string_view>(this->default_value.data(), this->default_value.size());
+}
\ No newline at end of file
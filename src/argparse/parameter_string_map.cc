@@ -0,0 +1,38 @@
+#include "argparse/parameter_string_map.h"
+
+using namespace argparse;
+
+parameter_string_map::parameter_string_map(std::string_view short_name, std::string_view name, std::string_view description, std::pmr::memory_resource* resource) : parameter(short_name, name, description, STRING_MAP, resource)
+{
+    this->target = &this->value;
+}
+
+parameter_string_map::~parameter_string_map()
+{
+}
+
+void parameter_string_map::get_value_to(void* p_value)
+{
+    *(string_map*)p_value = *this->target;
+}
+
+const string_map& parameter_string_map::get_value() const
+{
+    return *this->target;
+}
+
+void parameter_string_map::bind(string_map* target)
+{
+    this->target = target;
+}
+
+void parameter_string_map::assign(const value_slot& slot)
+{
+    *this->target = slot.map;
+}
+
+void parameter_string_map::capture_default(value_slot& slot)
+{
+    // the definitions of a bound map become the default
+    slot.map = *this->target;
+}
\ No newline at end of file
@@ -0,0 +1,89 @@
+#include "argparse/parse_result.h"
+#include "argparse/parser.h"
+
+using namespace argparse;
+
+parse_result::parse_result(std::pmr::memory_resource* resource) : values(resource), lists(resource), list_scratch(resource), list_counts(resource)
+{
+    this->spec = nullptr;
+    this->defaults_version = 0;
+}
+
+bool parse_result::get_parameter_value_to(std::string_view flag, void* value_buf) const
+{
+    if (this->spec == nullptr)
+    {
+        return false;
+    }
+    i32 id = this->spec->find_parameter(flag);
+    if (id < 0 || (u64)id >= this->values.size())
+    {
+        return false;
+    }
+    const value_table& values = resolve(id);
+    switch (this->spec->types[id])
+    {
+    case NONE:
+        *(bool*)value_buf = values.cells[id].flag;
+        break;
+    case INTEGER:
+        *(i64*)value_buf = values.cells[id].integer;
+        break;
+    case FLOAT:
+        *(f64*)value_buf = values.cells[id].real;
+        break;
+    case STRING:
+        ((std::string*)value_buf)->assign(values.texts[id].data(), values.texts[id].size());
+        break;
+    case STRING_LIST:
+    {
+        span<const std::string_view> items = parameter_traits<std::vector<std::string_view>>::from_table(values, id);
+        ((std::vector<std::string_view>*)value_buf)->assign(items.begin(), items.end());
+        break;
+    }
+    case INTEGER_LIST:
+    {
+        span<const i64> integers = parameter_traits<std::vector<i64>>::from_table(values, id);
+        ((std::vector<i64>*)value_buf)->assign(integers.begin(), integers.end());
+        break;
+    }
+    case FLOAT_LIST:
+    {
+        span<const f64> reals = parameter_traits<std::vector<f64>>::from_table(values, id);
+        ((std::vector<f64>*)value_buf)->assign(reals.begin(), reals.end());
+        break;
+    }
+    case STRING_MAP:
+        *(string_map*)value_buf = values.map(id);
+        break;
+    case FLAG_SET:
+        *(flag_set*)value_buf = values.flags(id);
+        break;
+    }
+    return true;
+}
+
+std::string_view parse_result::get_program_name() const
+{
+    return this->program_name;
+}
+
+const std::string& parse_result::get_error() const
+{
+    return this->error;
+}
+
+const value_table& parse_result::resolve(i32 id) const
+{
+    if (this->values.states[id] & value_table::DEFERRED)
+    {
+        std::string_view text = this->values.texts[id];
+        if (!this->spec->convert_deferred(id, this->values))
+        {
+            this->error.assign("error: invalid value ");
+            util::append_value(this->error, text);
+            this->error.append(" for parameter ").append(this->spec->option_name(id));
+        }
+    }
+    return this->values;
+}
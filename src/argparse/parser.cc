@@ -1,142 +1,740 @@
 #include "argparse/parser.h"
+#include "argparse/convert.h"
 #include <iostream>
 #include <cstdlib>
+#include <algorithm>
+#include <numeric>
 
 using namespace argparse;
 
-parser::parser()
+namespace
+{
+    // flags in parser::default_states
+    const u8 DEFAULT_CONVERTED = 1;   // defaults[id] holds the converted value
+    const u8 DEFAULT_INVALID = 2;     // the default text is not a valid value
+    const u8 VALUE_UNASSIGNED = 4;    // the parameter does not hold its current value yet
+    const u8 VALUE_BOUND = 8;         // the parameter writes to a caller's variable
+
+    // parser::integer_formats holds the base and this flag
+    const u8 INTEGER_BASE = 0x3f;
+    const u8 INTEGER_UNSIGNED = 0x80;
+
+    // Lists and maps collect every value given, see parser::assign_lists
+    bool is_list(u8 type)
+    {
+        return type == STRING_LIST || type == INTEGER_LIST || type == FLOAT_LIST || type == STRING_MAP;
+    }
+
+    // Split KEY=VALUE at the first '=', a definition without one has an empty
+    // value; false if the key is empty
+    bool split_definition(std::string_view text, std::string_view& key, std::string_view& value)
+    {
+        u64 equals = text.find('=');
+        key = text.substr(0, equals);
+        value = equals == std::string_view::npos ? std::string_view() : text.substr(equals + 1);
+        return !key.empty();
+    }
+
+    // Options whose own members allocate from the heap rather than from the
+    // parser's resource: the std::string of a string option and the
+    // std::vector of a list option
+    bool owns_heap_memory(u8 type)
+    {
+        return type == STRING || type == STRING_LIST || type == INTEGER_LIST || type == FLOAT_LIST;
+    }
+
+    // parser::defaults_version is drawn from one counter for all parsers, so
+    // a result that last parsed with another parser never matches it
+    std::atomic<u64> last_defaults_version(0);
+
+    u64 next_defaults_version()
+    {
+        return last_defaults_version.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+    // An empty list starts at the end of its item array, so that appended
+    // values extend it
+    void begin_range(value_range& range, u64 end)
+    {
+        if (range.count == 0)
+        {
+            range.offset = (u32)end;
+        }
+    }
+}
+
+parser::parser() : parser(std::pmr::get_default_resource())
+{
+}
+
+parser::parser(std::pmr::memory_resource* resource)
+    : resource(resource), parameters(resource), index(resource), program_name(resource), types(resource), integer_formats(resource), defaults(resource), default_states(resource), values_ready(true), state(resource), assigned(resource), positionals(resource), families(resource), stream_texts(resource), stream_values(resource), stream_lists(resource), stream_positionals(resource), list_texts(resource)
 {
+    defaults_version = next_defaults_version();
+    unassigned_defaults = false;
+    variadic = -1;
     auto_help_enabled = true; // Enable auto-help by default
+    deferred_conversion = false;
 }
 
 parser::~parser()
 {
-    // Delete all parameters
+    // A monotonic resource gets the options and everything they allocate from
+    // it back only when it is released, so only the options holding heap
+    // memory of their own are destroyed one by one; with any other resource
+    // every option is returned to it
+    bool monotonic = dynamic_cast<std::pmr::monotonic_buffer_resource*>(this->resource) != nullptr;
     for (auto p_parameter : this->parameters)
     {
-        delete p_parameter.second;
+        if (!monotonic || owns_heap_memory(p_parameter->get_type()))
+        {
+            util::destroy_parameter(p_parameter, this->resource);
+        }
     }
 }
 
-void argparse::parser::add_parameter(std::string short_name, std::string name, std::string description, parameter_type type, bool required, std::string default_value)
+void argparse::parser::add_parameter(std::string_view short_name, std::string_view name, std::string_view description, parameter_type type, bool required, std::string_view default_value)
+{
+    register_parameter(short_name, name, description, type, required, default_value);
+}
+
+i32 argparse::parser::register_parameter(std::string_view short_name, std::string_view name, std::string_view description, parameter_type type, bool required, std::string_view default_value)
 {
+    i32 id = register_parameter(short_name, name, description, type, required);
+    if (id >= 0)
+    {
+        set_default(id, default_value);
+    }
+    return id;
+}
+
+i32 parser::register_positional(std::string_view name, std::string_view description, parameter_type type, bool required, std::string_view default_value)
+{
+    if (type == STRING_LIST && this->variadic >= 0)
+    {
+        return -1;
+    }
+    parameter* p_parameter = util::create_parameter("", name, description, type, this->resource);
+    if (p_parameter == nullptr)
+    {
+        return -1;
+    }
+    p_parameter->set_required(required);
+    i32 id = append_parameter(p_parameter);
+    this->positionals.push_back(id);
+    if (type == STRING_LIST)
+    {
+        this->variadic = id;
+    }
+    set_default(id, default_value);
+    return id;
+}
+
+handle<std::vector<std::string_view>> parser::add_variadic(std::string_view name, std::string_view description, bool required)
+{
+    return handle<std::vector<std::string_view>>(register_positional(name, description, STRING_LIST, required, std::string_view()));
+}
+
+handle<flag_set> parser::add_flag_family(std::string_view name, std::string_view enable_prefix, std::string_view disable_prefix, std::string_view description)
+{
+    if (enable_prefix.empty() || enable_prefix[0] != '-' || disable_prefix.empty() || disable_prefix[0] != '-')
+    {
+        return handle<flag_set>();
+    }
+    parameter* p_parameter = util::create_parameter("", name, description, FLAG_SET, this->resource);
+    if (p_parameter == nullptr)
+    {
+        return handle<flag_set>();
+    }
+    static_cast<parameter_flag_set*>(p_parameter)->set_prefixes(enable_prefix, disable_prefix);
+    // like positionals, families are kept out of the option index
+    i32 id = append_parameter(p_parameter);
+    this->families.push_back(id);
+    capture_default(id);
+    return handle<flag_set>(id);
+}
+
+i32 parser::add_flag(handle<flag_set> family, std::string_view name, bool enabled)
+{
+    i32 id = family.get_id();
+    if (id < 0 || (u64)id >= this->parameters.size() || this->types[id] != FLAG_SET)
+    {
+        return -1;
+    }
+    i32 flag = static_cast<parameter_flag_set*>(this->parameters[id])->add_flag(name, enabled);
+    if (flag < 0)
+    {
+        return -1;
+    }
+    // extend the default in place while there is room in its last word, or
+    // its words end the table, so that adding flags one by one does not
+    // leave a stale copy of the family behind for every flag
+    value_range& range = this->defaults.cells[id].range;
+    std::pmr::vector<u64>& words = this->defaults.flag_words;
+    u64 word = range.offset + (u64)flag / 64;
+    if (flag % 64 != 0 || word == words.size())
+    {
+        if (word == words.size())
+        {
+            words.push_back(0);
+        }
+        words[word] |= (u64)enabled << (flag % 64);
+        range.count++;
+        defaults_version = next_defaults_version();
+    }
+    else
+    {
+        capture_default(id);
+    }
+    return flag;
+}
+
+i32 parser::find_flag(handle<flag_set> family, std::string_view name) const
+{
+    i32 id = family.get_id();
+    if (id < 0 || (u64)id >= this->parameters.size() || this->types[id] != FLAG_SET)
+    {
+        return -1;
+    }
+    return static_cast<const parameter_flag_set*>(this->parameters[id])->find_flag(name);
+}
+
+void parser::set_default(i32 id, std::string_view default_value)
+{
+    if (types[id] != NONE && !default_value.empty())
+    {
+        // kept as text until it is needed, see default_slot
+        parameters[id]->set_default_text(default_value);
+        defaults.reset(id);
+        defaults_version = next_defaults_version();
+        default_states[id] = VALUE_UNASSIGNED;
+        values_ready.store(false);
+        unassigned_defaults = true;
+    }
+    else
+    {
+        capture_default(id);
+    }
+}
+
+i32 parser::append_parameter(parameter* p_parameter)
+{
+    i32 id = (i32)parameters.size();
+    parameters.push_back(p_parameter);
+    defaults.push_back();
+    defaults_version = next_defaults_version();
+    default_states.push_back(DEFAULT_CONVERTED);
+    types.push_back((u8)p_parameter->get_type());
+    integer_formats.push_back(0);
+    if (p_parameter->get_type() == INTEGER)
+    {
+        const parameter_integer* p_integer = static_cast<const parameter_integer*>(p_parameter);
+        integer_formats[id] = (u8)p_integer->get_base() | (p_integer->get_signed() ? 0 : INTEGER_UNSIGNED);
+    }
+    return id;
+}
+
+i32 argparse::parser::register_parameter(std::string_view short_name, std::string_view name, std::string_view description, parameter_type type, bool required)
+{
+    // each name must be free or belong to one option registered with exactly
+    // these names; an option that shares only one of them is a conflict
+    i32 short_id = short_name != "" ? index.find_short(short_name) : -1;
+    i32 long_id = name != "" ? index.find_long(name) : -1;
+    i32 id = short_id >= 0 ? short_id : long_id;
+    if (id >= 0 && ((short_id >= 0 && long_id >= 0 && short_id != long_id) || parameters[id]->get_short_name() != short_name || parameters[id]->get_name() != name))
+    {
+        std::cerr << "error: parameter " << (name != "" ? name : short_name) << " shares a name with parameter " << option_name(id) << std::endl;
+        return -1;
+    }
+
     parameter* p_parameter = nullptr;
-    p_parameter = util::create_parameter(short_name, name, description, type);
+    p_parameter = util::create_parameter(short_name, name, description, type, this->resource);
     if (p_parameter != nullptr)
     {
-        if (type != NONE)
-            p_parameter->set(default_value);
         p_parameter->set_required(required);
-        std::string key = short_name + '\n' + name;
-        parameters[key] = p_parameter;
+
+        // registering the same names and type again replaces the option, so an
+        // id always refers to an option of the same type; another type takes
+        // the names over, leaving the old option to its handles
+        if (id >= 0 && parameters[id]->get_type() == type)
+        {
+            util::destroy_parameter(parameters[id], this->resource);
+            parameters[id] = p_parameter;
+            if ((u64)id < this->state.values.size())
+            {
+                this->state.values.reset(id);
+            }
+        }
+        else
+        {
+            id = append_parameter(p_parameter);
+        }
+        if (type == INTEGER)
+        {
+            const parameter_integer* p_integer = static_cast<const parameter_integer*>(p_parameter);
+            integer_formats[id] = (u8)p_integer->get_base() | (p_integer->get_signed() ? 0 : INTEGER_UNSIGNED);
+        }
+
+        // the index refers to the names owned by the parameter
         if (short_name != "")
         {
-            short_name_query[short_name] = key;
+            index.add_short(p_parameter->get_short_name(), id);
         }
         if (name != "")
         {
-            name_query[name] = key;
+            index.add_long(p_parameter->get_name(), id);
         }
+        return id;
     }
+    return -1;
 }
 
+bool parser::is_replaced(i32 id) const
+{
+    std::string_view short_name = this->parameters[id]->get_short_name();
+    i32 current = short_name != "" ? index.find_short(short_name) : index.find_long(this->parameters[id]->get_name());
+    return current >= 0 && current != id;
+}
+
+void argparse::parser::capture_default(i32 id)
+{
+    value_slot slot = value_slot();
+    parameters[id]->capture_default(slot);
+    defaults.set_slot(id, (parameter_type)types[id], slot);
+    defaults_version = next_defaults_version();
+    default_states[id] = DEFAULT_CONVERTED;
+}
+
+void parser::capture_bound_default(i32 id)
+{
+    capture_default(id);
+    default_states[id] |= VALUE_BOUND;
+}
+
+value_slot parser::default_slot(i32 id) const
+{
+    if (!(default_states[id] & DEFAULT_CONVERTED))
+    {
+        if (!convert_text(id, parameters[id]->get_default_text(), defaults))
+        {
+            defaults.reset(id);
+            default_states[id] |= DEFAULT_INVALID;
+        }
+        defaults_version = next_defaults_version();
+        default_states[id] |= DEFAULT_CONVERTED;
+    }
+    return defaults.get_slot(id, (parameter_type)types[id]);
+}
+
+void parser::assign_value(i32 id)
+{
+    if (values_ready.load(std::memory_order_acquire))
+    {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(values_lock);
+    if (default_states[id] & VALUE_UNASSIGNED)
+    {
+        assign_pending(id);
+    }
+}
+
+void parser::assign_pending(i32 id) const
+{
+    // the value of the last parse, or the default if there was none
+    value_slot slot;
+    value_table& values = this->state.values;
+    if ((u64)id < values.size() && (values.states[id] & value_table::PRESENT))
+    {
+        std::string_view text = values.texts[id];
+        if ((values.states[id] & value_table::DEFERRED) && !convert_deferred(id, values))
+        {
+            std::string message("error: invalid value ");
+            util::append_value(message, text);
+            std::cerr << message << " for parameter " << option_name(id) << std::endl;
+        }
+        slot = values.get_slot(id, (parameter_type)types[id]);
+    }
+    else
+    {
+        slot = default_slot(id);
+    }
+    parameters[id]->assign(slot);
+    default_states[id] &= (u8)~VALUE_UNASSIGNED;
+}
+
+bool parser::convert_deferred(i32 id, value_table& values) const
+{
+    values.states[id] &= (u8)~value_table::DEFERRED;
+    if (!convert_text(id, values.texts[id], values))
+    {
+        // an invalid value reads as the default
+        value_slot slot = default_slot(id);
+        slot.present = true;
+        values.set_slot(id, (parameter_type)types[id], slot);
+        return false;
+    }
+    return true;
+}
+
+bool parser::convert_text(i32 id, std::string_view text, value_table& values) const
+{
+    value_cell& cell = values.cells[id];
+    switch (this->types[id])
+    {
+    case NONE:
+        cell.flag = true;
+        return true;
+    case INTEGER:
+    {
+        int base = this->integer_formats[id] & INTEGER_BASE;
+        if (this->integer_formats[id] & INTEGER_UNSIGNED)
+        {
+            u64 unsigned_value = 0;
+            if (convert::to_integer(text, unsigned_value, base) != CONVERT_OK)
+            {
+                return false;
+            }
+            cell.integer = (i64)unsigned_value;
+            return true;
+        }
+        return convert::to_integer(text, cell.integer, base) == CONVERT_OK;
+    }
+    case FLOAT:
+        return convert::to_float(text, cell.real) == CONVERT_OK;
+    case STRING:
+        values.texts[id] = text;
+        return true;
+    case STRING_LIST:
+        begin_range(cell.range, values.items.size());
+        values.items.push_back(text);
+        cell.range.count++;
+        return true;
+    case INTEGER_LIST:
+    {
+        begin_range(cell.range, values.integer_items.size());
+        u64 before = values.integer_items.size();
+        if (convert::to_integers(text, ',', values.integer_items) != CONVERT_OK)
+        {
+            return false;
+        }
+        cell.range.count += (u32)(values.integer_items.size() - before);
+        return true;
+    }
+    case FLOAT_LIST:
+    {
+        begin_range(cell.range, values.real_items.size());
+        u64 before = values.real_items.size();
+        if (convert::to_floats(text, ',', values.real_items) != CONVERT_OK)
+        {
+            return false;
+        }
+        cell.range.count += (u32)(values.real_items.size() - before);
+        return true;
+    }
+    case FLAG_SET:
+        // flags are switched by their own tokens, see parse_flag
+        return false;
+    case STRING_MAP:
+    {
+        // a default holds one definition, given values are defined by assign_lists
+        std::string_view key;
+        std::string_view value;
+        if (!split_definition(text, key, value))
+        {
+            return false;
+        }
+        values.begin_map(id, 1);
+        values.define(id, key, value);
+        return true;
+    }
+    }
+    return false;
+}
+
+std::string_view parser::option_name(i32 id) const
+{
+    const parameter* p_parameter = this->parameters[id];
+    return p_parameter->get_name().empty() ? p_parameter->get_short_name() : p_parameter->get_name();
+}
+
+void parser::convert_defaults() const
+{
+    if (values_ready.load(std::memory_order_acquire))
+    {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(values_lock);
+    if (values_ready.load(std::memory_order_relaxed))
+    {
+        return;
+    }
+    for (u64 id = 0; id < this->parameters.size(); id++)
+    {
+        default_slot((i32)id);
+        if (default_states[id] & VALUE_UNASSIGNED)
+        {
+            assign_pending((i32)id);
+        }
+    }
+    values_ready.store(true, std::memory_order_release);
+}
+
+bool parser::freeze(bool validate_defaults)
+{
+    convert_defaults();
+    if (!validate_defaults)
+    {
+        return true;
+    }
+    bool valid = true;
+    for (u64 id = 0; id < this->parameters.size(); id++)
+    {
+        if (default_states[id] & DEFAULT_INVALID)
+        {
+            std::cerr << "error: invalid default value " << this->parameters[id]->get_default_text() << " for parameter " << option_name((i32)id) << std::endl;
+            valid = false;
+        }
+    }
+    return valid;
+}
+
 std::string argparse::parser::get_help_message()
 {
     std::string help_message = "";
-    help_message += std::string("Usage: ") + program_name + " [options]";
-    for (auto p_parameter : this->parameters)
+    help_message += std::string("Usage: ");
+    help_message += program_name;
+    help_message += " [options]";
+    // positionals in declaration order, <required> or [optional]
+    for (i32 id : this->positionals)
+    {
+        bool required = this->parameters[id]->get_required();
+        help_message += required ? " <" : " [";
+        help_message += this->parameters[id]->get_name();
+        help_message += id == this->variadic ? "..." : "";
+        help_message += required ? ">" : "]";
+    }
+
+    // list options sorted by short name, then by long name
+    std::vector<u32> order(this->parameters.size());
+    std::iota(order.begin(), order.end(), 0);
+    order.erase(std::remove_if(order.begin(), order.end(), [this](u32 id)
+    {
+        return std::find(this->positionals.begin(), this->positionals.end(), (i32)id) != this->positionals.end() || this->types[id] == FLAG_SET || is_replaced((i32)id);
+    }), order.end());
+    std::sort(order.begin(), order.end(), [this](u32 a, u32 b)
+    {
+        const parameter* p_a = this->parameters[a];
+        const parameter* p_b = this->parameters[b];
+        if (p_a->get_short_name() != p_b->get_short_name())
+        {
+            return p_a->get_short_name() < p_b->get_short_name();
+        }
+        return p_a->get_name() < p_b->get_name();
+    });
+
+    for (u32 id : order)
     {
+        const parameter* p_parameter = this->parameters[id];
         help_message += std::string("\n");
-        if (p_parameter.second->get_short_name() != "")
+        if (p_parameter->get_short_name() != "")
         {
-            help_message += std::string("-") + p_parameter.second->get_short_name();
+            help_message += std::string("-");
+            help_message += p_parameter->get_short_name();
             help_message += std::string(", ");
         }
-        if (p_parameter.second->get_name() != "")
+        if (p_parameter->get_name() != "")
         {
-            help_message += std::string("--") + p_parameter.second->get_name();
+            help_message += std::string("--");
+            help_message += p_parameter->get_name();
         }
-        help_message += std::string("\t") + p_parameter.second->get_description();
-        if (p_parameter.second->get_short_name() == "" && p_parameter.second->get_name() == "")
+        help_message += std::string("\t");
+        help_message += p_parameter->get_description();
+        if (p_parameter->get_short_name() == "" && p_parameter->get_name() == "")
         {
             help_message = "error: parameter has no name or short name";
             return help_message;
         }
     }
+    // one line per flag family, such as "-f<feature>, -fno-<feature>"
+    for (i32 id : this->families)
+    {
+        const parameter_flag_set* p_family = static_cast<const parameter_flag_set*>(this->parameters[id]);
+        std::string placeholder = "<" + std::string(p_family->get_name()) + ">";
+        help_message += std::string("\n");
+        help_message += p_family->get_enable_prefix();
+        help_message += placeholder;
+        help_message += std::string(", ");
+        help_message += p_family->get_disable_prefix();
+        help_message += placeholder;
+        help_message += std::string("\t");
+        help_message += p_family->get_description();
+    }
+    for (i32 id : this->positionals)
+    {
+        help_message += std::string("\n");
+        help_message += this->parameters[id]->get_name();
+        help_message += std::string("\t");
+        help_message += this->parameters[id]->get_description();
+    }
     return help_message;
 }
 
-bool parser::parse(std::vector<std::string> args)
+bool parser::parse(const std::vector<std::string>& args)
 {
-    //get program name by removing path
-    this->program_name = args[0];
-    size_t last_slash = this->program_name.find_last_of("\\/");
-    if (last_slash != std::string::npos)
+    return parse_tokens(token_list(args), true);
+}
+
+bool parser::parse(int argc, char** argv)
+{
+    return parse_tokens(token_list(argc, argv), true);
+}
+
+bool parser::parse(span<const std::string_view> args)
+{
+    return parse_tokens(token_list(args), false);
+}
+
+bool parser::parse(const std::vector<std::string>& args, parse_result& result) const
+{
+    convert_defaults();
+    return parse_tokens(token_list(args), result, this->deferred_conversion);
+}
+
+bool parser::parse(int argc, const char* const* argv, parse_result& result) const
+{
+    convert_defaults();
+    return parse_tokens(token_list(argc, argv), result, this->deferred_conversion);
+}
+
+bool parser::parse(span<const std::string_view> args, parse_result& result) const
+{
+    convert_defaults();
+    return parse_tokens(token_list(args), result, this->deferred_conversion);
+}
+
+bool parser::parse_cmdline(std::string_view cmdline, parse_result& result) const
+{
+    convert_defaults();
+    return parse_tokens(token_list(cmdline, '\0'), result, this->deferred_conversion);
+}
+
+bool parser::parse_stream(int fd, char delimiter, const std::function<void(std::string_view)>& positional)
+{
+    token_stream tokens(fd, delimiter, 64 * 1024, this->resource);
+    return parse_stream(tokens, positional);
+}
+
+bool parser::parse_stream(std::istream& in, char delimiter, const std::function<void(std::string_view)>& positional)
+{
+    token_stream tokens(in, delimiter, 64 * 1024, this->resource);
+    return parse_stream(tokens, positional);
+}
+
+bool parser::parse_stream(token_stream& tokens, const std::function<void(std::string_view)>& positional)
+{
+    return finish_parse(parse_stream_tokens(tokens, positional));
+}
+
+bool parser::parse_tokens(const token_list& args, bool own_lists)
+{
+    bool parsed = parse_tokens(args, this->state, this->deferred_conversion);
+    if (parsed && args.size() > 0)
     {
-        this->program_name = this->program_name.substr(last_slash + 1);
+        this->program_name.assign(this->state.program_name.data(), this->state.program_name.size());
     }
+    if (parsed && own_lists)
+    {
+        own_list_values();
+    }
+    return finish_parse(parsed);
+}
 
-    args.erase(args.begin());
-
-    for (u64 i = 0; i < args.size(); i++)
+void parser::own_list_values()
+{
+    value_table& values = this->state.values;
+    // call visit on every view of the text lists and maps given in the parse
+    auto each_text = [&](auto visit)
     {
-        std::string current = args[i];
-        std::string key = "";
-        if (current[0] == '-')
+        for (i32 id : values.touched)
         {
-            bool short_name = true;
-            current = current.substr(1);
-            if (current[0] == '-')
-            {
-                short_name = false;
-                current = current.substr(1);
-            }
-            if (short_name)
-            {
-                key = short_name_query[current];
-            }
-            else
+            if (!(values.states[id] & value_table::PRESENT))
             {
-                key = name_query[current];
+                continue;
             }
-            if (key == "")
+            const value_range& range = values.cells[id].range;
+            if (this->types[id] == STRING_LIST)
             {
-                std::cerr << "error: unknown parameter " << current << std::endl;
-                if (auto_help_enabled)
+                for (u64 n = range.offset; n < range.offset + range.count; n++)
                 {
-                    print_help_and_exit();
+                    visit(values.items[n]);
                 }
-                return false;
-            }
-            parameter* p_parameter = parameters[key];
-            if (p_parameter->get_type() == NONE)
-            {
-                p_parameter->set("");
             }
-            else
+            else if (this->types[id] == STRING_MAP && range.count > 0)
             {
-                i++;
-                if (i >= args.size() || args[i][0] == '-')
+                map_entry* entries = values.map_entries.data() + values.map_slots[range.offset];
+                for (u64 n = 0; n < range.count; n++)
                 {
-                    std::cerr << "error: parameter " << current << " requires a value" << std::endl;
-                    if (auto_help_enabled)
-                    {
-                        print_help_and_exit();
-                    }
-                    return false;
+                    visit(entries[n].key);
+                    visit(entries[n].value);
                 }
-                p_parameter->set(args[i]);
             }
         }
-        else 
+    };
+    // size the buffer first, so that it does not move once views point into it
+    u64 size = 0;
+    each_text([&](std::string_view& text)
+    {
+        size += text.size();
+    });
+    this->list_texts.clear();
+    this->list_texts.reserve(size);
+    each_text([&](std::string_view& text)
+    {
+        const char* copy = this->list_texts.data() + this->list_texts.size();
+        this->list_texts.append(text.data(), text.size());
+        text = std::string_view(copy, text.size());
+    });
+}
+
+bool parser::finish_parse(bool parsed)
+{
+    if (!parsed)
+    {
+        std::cerr << this->state.get_error() << std::endl;
+        if (auto_help_enabled)
+        {
+            print_help_and_exit();
+        }
+        return false;
+    }
+
+    // options given in this parse or the last one take the value of this
+    // parse or their default, and every other option already holds its
+    // default, so nothing carries over from an earlier parse and reading a
+    // value never converts one. Defaults of options that were given are
+    // never converted.
+    if (this->unassigned_defaults)
+    {
+        for (u64 id = 0; id < this->parameters.size(); id++)
         {
-            if (auto_help_enabled)
+            if (default_states[id] & VALUE_UNASSIGNED)
             {
-                print_help_and_exit();
+                assign_pending((i32)id);
             }
-            return false;
         }
+        this->unassigned_defaults = false;
     }
+    const std::pmr::vector<i32>& given = this->state.values.touched;
+    for (i32 id : this->assigned)
+    {
+        assign_pending(id);
+    }
+    for (i32 id : given)
+    {
+        assign_pending(id);
+    }
+    this->assigned.assign(given.begin(), given.end());
     
     // Check if help was requested after successful parsing
     if (auto_help_enabled && is_help_requested())
@@ -145,73 +743,586 @@ bool parser::parse(std::vector<std::string> args)
     }
     
     return true;
+}
+
+template<typename N, typename S>
+bool parser::parse_option(std::string_view token, token_kind kind, u32 separator, parse_result& result, N next, S store) const
+{
+    value_table& values = result.values;
+
+    // store value, and name the option in messages as it was written: by
+    // then a streamed token may already be overwritten
+    auto assign = [&](i32 id, std::string_view name, std::string_view value) {
+        values.touch(id);
+        if (!store(id, value))
+        {
+            result.error.assign("error: invalid value ");
+            util::append_value(result.error, value);
+            result.error.append(" for parameter ").append(name);
+            return false;
+        }
+        values.states[id] |= value_table::PRESENT;
+        return true;
+    };
+    // the next token is the value unless it is an option, but a numeric
+    // option takes a negative number that is not itself a short option
+    auto assign_next = [&](i32 id, std::string_view name) {
+        std::string_view value;
+        token_kind value_kind = TOKEN_POSITIONAL;
+        bool found = next(value, value_kind);
+        u8 type = this->types[id];
+        bool numeric = type == INTEGER || type == FLOAT || type == INTEGER_LIST || type == FLOAT_LIST;
+        bool negative = numeric && value_kind == TOKEN_SHORT && is_negative_number(value) && index.find_short(value.substr(1)) < 0;
+        if (!found || (value_kind != TOKEN_POSITIONAL && !negative))
+        {
+            result.error.assign("error: parameter ").append(name).append(" requires a value");
+            return false;
+        }
+        return assign(id, name, value);
+    };
+
+    if (kind != TOKEN_SHORT)
+    {
+        std::string_view name = token.substr(2, kind == TOKEN_LONG_VALUE ? separator - 2 : std::string_view::npos);
+        i32 id = index.find_long(name);
+        if (id < 0 && kind == TOKEN_LONG && !this->families.empty() && parse_flag(token, values))
+        {
+            return true;
+        }
+        if (id < 0)
+        {
+            result.error.assign("error: unknown parameter ");
+            util::append_value(result.error, name);
+            return false;
+        }
+        name = this->parameters[id]->get_name();
+        if (kind == TOKEN_LONG_VALUE)
+        {
+            if (this->types[id] == NONE)
+            {
+                result.error.assign("error: parameter ").append(name).append(" does not take a value");
+                return false;
+            }
+            return assign(id, name, token.substr(separator + 1));
+        }
+        if (this->types[id] != NONE)
+        {
+            return assign_next(id, name);
+        }
+        values.touch(id);
+        values.cells[id].flag = true;
+        values.states[id] |= value_table::PRESENT;
+        return true;
+    }
+
+    // a short name may be longer than one character, so the whole token is
+    // tried first and only then split into single character options
+    std::string_view body = token.substr(1);
+    i32 id = index.find_short(body);
+    // a flag of a family, such as -fno-name, is never split
+    if (id < 0 && !this->families.empty() && parse_flag(token, values))
+    {
+        return true;
+    }
+    if (id < 0 && body.size() < 2)
+    {
+        result.error.assign("error: unknown parameter ");
+        util::append_value(result.error, body);
+        return false;
+    }
+    for (u64 at = 0; at < body.size(); at++)
+    {
+        if (id < 0)
+        {
+            id = index.find_short(body.substr(at, 1));
+            if (id < 0)
+            {
+                result.error.assign("error: unknown parameter ");
+                util::append_value(result.error, at == 0 ? body : body.substr(at, 1));
+                return false;
+            }
+        }
+        else
+        {
+            at = body.size() - 1;
+        }
+        std::string_view name = this->parameters[id]->get_short_name();
+        if (this->types[id] != NONE)
+        {
+            // the rest of the token is the value, as in -ofile or -n-5
+            std::string_view attached = body.substr(at + 1);
+            return attached.empty() ? assign_next(id, name) : assign(id, name, attached);
+        }
+        values.touch(id);
+        values.cells[id].flag = true;
+        values.states[id] |= value_table::PRESENT;
+        id = -1;
+    }
+    return true;
+}
+
+bool parser::parse_flag(std::string_view token, value_table& values) const
+{
+    for (i32 id : this->families)
+    {
+        bool enabled = false;
+        i32 flag = static_cast<const parameter_flag_set*>(this->parameters[id])->match(token, enabled);
+        if (flag >= 0)
+        {
+            // the family's words are copied before the first flag is switched,
+            // as the default's words stay in place for the next parse
+            value_range& range = values.cells[id].range;
+            if (!(values.states[id] & value_table::TOUCHED))
+            {
+                values.touch(id);
+                u64 offset = values.flag_words.size();
+                u64 words = (range.count + 63) / 64;
+                values.flag_words.resize(offset + words);
+                std::copy_n(values.flag_words.begin() + range.offset, words, values.flag_words.begin() + offset);
+                range.offset = (u32)offset;
+            }
+            // the last token for a flag wins
+            u64& word = values.flag_words[range.offset + (u64)flag / 64];
+            u64 bit = 1ull << (flag % 64);
+            word = enabled ? word | bit : word & ~bit;
+            values.states[id] |= value_table::PRESENT;
+            return true;
+        }
+    }
+    return false;
+}
+
+void parser::restore_defaults(parse_result& result) const
+{
+    // a parse touches only the options it names, so undoing it costs as
+    // much as the parse did, where copying the defaults costs every option
+    value_table& values = result.values;
+    if (result.spec == this && result.defaults_version == this->defaults_version && values.size() == this->defaults.size())
+    {
+        values.restore(this->defaults);
+        return;
+    }
+    result.spec = this;
+    result.defaults_version = this->defaults_version;
+    values.assign(this->defaults);
+}
+
+bool parser::parse_tokens(const token_list& args, parse_result& result, bool defer) const
+{
+    restore_defaults(result);
+    result.program_name = std::string_view();
+    result.error.clear();
+    result.lists.clear();
+
+    if (args.size() == 0)
+    {
+        return true;
+    }
+
+    //get program name by removing path
+    std::string_view program = args[0];
+    size_t last_slash = program.find_last_of("\\/");
+    if (last_slash != std::string_view::npos)
+    {
+        program.remove_prefix(last_slash + 1);
+    }
+    result.program_name = program;
+
+    // fetch each token once: on argv every access measures the token, which
+    // must stay linear for very long values
+    u64 i = 1;
+    auto next = [&](std::string_view& value, token_kind& kind) {
+        if (++i >= args.size())
+        {
+            return false;
+        }
+        u32 separator = 0;
+        value = args[i];
+        kind = classify_token(value, separator);
+        return true;
+    };
+    auto store = [&](i32 id, std::string_view value) {
+        if (is_list(this->types[id]))
+        {
+            result.lists.push_back(parse_result::list_value{id, value});
+            return true;
+        }
+        if (defer)
+        {
+            result.values.texts[id] = value;
+            result.values.states[id] |= value_table::DEFERRED;
+            return true;
+        }
+        return convert_text(id, value, result.values);
+    };
+
+    // positional tokens are collected in items, without a variadic
+    // positional only as many as are declared
+    std::pmr::vector<std::string_view>& items = result.values.items;
+    u64 first = items.size();
+    u64 capacity = this->variadic >= 0 ? args.size() : this->positionals.size();
+    bool options_ended = false;
+    for (; i < args.size(); i++)
+    {
+        std::string_view current = args[i];
+        u32 separator = 0;
+        token_kind kind = options_ended ? TOKEN_POSITIONAL : classify_token(current, separator);
+        if (kind == TOKEN_TERMINATOR)
+        {
+            // everything after "--" is an argument
+            options_ended = true;
+            continue;
+        }
+        if (kind == TOKEN_POSITIONAL)
+        {
+            if (items.size() - first >= capacity)
+            {
+                result.error.assign("error: unexpected argument ");
+                util::append_value(result.error, current);
+                return false;
+            }
+            items.push_back(current);
+            continue;
+        }
+        if (!parse_option(current, kind, separator, result, next, store))
+        {
+            return false;
+        }
+    }
+    
+    return assign_positionals(result, first, defer) && assign_lists(result);
 }
 
-bool parser::parse(int argc, char** argv)
-{
-    std::vector<std::string> args;
-    for (int i = 0; i < argc; i++)
-    {
-        args.push_back(argv[i]);
-    }
-    return parse(args);
-}
-
-bool parser::get_parameter_value_to(std::string flag, void* value_buf)
+bool parser::assign_positionals(parse_result& result, u64 first, bool defer) const
 {
-    std::string key = "";
-    
-    // Handle flags with dashes
-    if (flag[0] == '-')
+    value_table& values = result.values;
+    u64 count = values.items.size() - first;
+    u64 needed = 0;
+    for (i32 id : this->positionals)
+    {
+        needed += this->parameters[id]->get_required() ? 1 : 0;
+    }
+    // tokens beyond the required ones go to the optional positionals in
+    // order, and the rest to the variadic one
+    u64 extra = count > needed ? count - needed : 0;
+    u64 at = first;
+    for (i32 id : this->positionals)
     {
-        flag = flag.substr(1);
-        if (flag[0] == '-')
+        bool required = this->parameters[id]->get_required();
+        if (id == this->variadic)
         {
-            // Long name (--flag)
-            flag = flag.substr(1);
-            key = name_query[flag];
+            u64 taken = std::min<u64>(values.items.size() - at, (required ? 1 : 0) + extra);
+            if (required && taken == 0)
+            {
+                result.error.assign("error: missing argument ").append(option_name(id));
+                return false;
+            }
+            if (taken > 0)
+            {
+                values.touch(id);
+                values.cells[id].range.offset = (u32)at;
+                values.cells[id].range.count = (u32)taken;
+                values.states[id] |= value_table::PRESENT;
+            }
+            extra = 0;
+            at += taken;
+            continue;
+        }
+        if (!required && extra == 0)
+        {
+            continue;
+        }
+        if (at >= values.items.size())
+        {
+            result.error.assign("error: missing argument ").append(option_name(id));
+            return false;
+        }
+        extra -= required ? 0 : 1;
+        std::string_view value = values.items[at++];
+        values.touch(id);
+        if (defer)
+        {
+            values.texts[id] = value;
+            values.states[id] |= value_table::DEFERRED;
+        }
+        else if (!convert_text(id, value, values))
+        {
+            result.error.assign("error: invalid value ");
+            util::append_value(result.error, value);
+            result.error.append(" for parameter ").append(option_name(id));
+            return false;
+        }
+        values.states[id] |= value_table::PRESENT;
+    }
+    return true;
+}
+
+bool parser::assign_lists(parse_result& result) const
+{
+    std::pmr::vector<parse_result::list_value>& lists = result.lists;
+    if (lists.empty())
+    {
+        return true;
+    }
+    // group the values by option with a stable counting sort, unless each
+    // option's values already follow one another
+    auto by_id = [](const parse_result::list_value& a, const parse_result::list_value& b)
+    {
+        return a.id < b.id;
+    };
+    if (!std::is_sorted(lists.begin(), lists.end(), by_id))
+    {
+        std::pmr::vector<u32>& starts = result.list_counts;
+        starts.assign(this->parameters.size() + 1, 0);
+        for (const parse_result::list_value& value : lists)
+        {
+            starts[value.id + 1]++;
+        }
+        for (u64 id = 1; id < starts.size(); id++)
+        {
+            starts[id] += starts[id - 1];
+        }
+        result.list_scratch.resize(lists.size());
+        for (const parse_result::list_value& value : lists)
+        {
+            result.list_scratch[starts[value.id]++] = value;
+        }
+        lists.swap(result.list_scratch);
+    }
+
+    value_table& values = result.values;
+    u64 end = 0;
+    for (u64 begin = 0; begin < lists.size(); begin = end)
+    {
+        i32 id = lists[begin].id;
+        for (end = begin + 1; end < lists.size() && lists[end].id == id; end++)
+        {
+        }
+        // values given replace the default; a map's table is sized once for
+        // all of its definitions
+        values.touch(id);
+        bool map = this->types[id] == STRING_MAP;
+        if (map)
+        {
+            values.begin_map(id, end - begin);
         }
         else
         {
-            // Short name (-f)
-            key = short_name_query[flag];
+            values.cells[id].range.count = 0;
+        }
+        for (u64 i = begin; i < end; i++)
+        {
+            std::string_view text = lists[i].text;
+            std::string_view key;
+            std::string_view value;
+            bool valid = map ? split_definition(text, key, value) : convert_text(id, text, values);
+            if (!valid)
+            {
+                result.error.assign("error: invalid value ");
+                util::append_value(result.error, text);
+                result.error.append(" for parameter ").append(option_name(id));
+                return false;
+            }
+            if (map)
+            {
+                values.define(id, key, value);
+            }
         }
     }
-    else
+    return true;
+}
+
+bool parser::parse_stream_tokens(token_stream& tokens, const std::function<void(std::string_view)>& positional)
+{
+    parse_result& result = this->state;
+    restore_defaults(result);
+    result.program_name = std::string_view();
+    result.error.clear();
+    result.lists.clear();
+    this->stream_texts.resize(this->parameters.size());
+    this->stream_values.clear();
+    this->stream_lists.clear();
+    this->stream_positionals.clear();
+    // keep a value in stream_values until every token is read
+    auto keep = [&](std::string_view value, std::pmr::vector<value_range>& ranges) {
+        ranges.push_back(value_range{(u32)this->stream_values.size(), (u32)value.size()});
+        this->stream_values.append(value.data(), value.size());
+    };
+
+    auto next = [&](std::string_view& value, token_kind& kind) {
+        if (!tokens.next(value))
+        {
+            return false;
+        }
+        u32 separator = 0;
+        kind = classify_token(value, separator);
+        return true;
+    };
+    // text that outlives this token is copied into the option's own string,
+    // whose capacity is kept for the next stream
+    auto store = [&](i32 id, std::string_view value) {
+        value_table& values = result.values;
+        if (is_list(this->types[id]))
+        {
+            keep(value, this->stream_lists);
+            result.lists.push_back(parse_result::list_value{id, std::string_view()});
+            return true;
+        }
+        if (this->deferred_conversion)
+        {
+            this->stream_texts[id].assign(value.data(), value.size());
+            values.texts[id] = this->stream_texts[id];
+            values.states[id] |= value_table::DEFERRED;
+            return true;
+        }
+        if (!convert_text(id, value, values))
+        {
+            return false;
+        }
+        if (this->types[id] == STRING)
+        {
+            this->stream_texts[id].assign(value.data(), value.size());
+            values.texts[id] = this->stream_texts[id];
+        }
+        return true;
+    };
+
+    std::string_view current;
+    bool options_ended = false;
+    while (tokens.next(current))
     {
-        // No dashes - try short name first, then long name
-        key = short_name_query[flag];
-        if (key == "")
+        u32 separator = 0;
+        token_kind kind = options_ended ? TOKEN_POSITIONAL : classify_token(current, separator);
+        if (kind == TOKEN_TERMINATOR)
+        {
+            options_ended = true;
+            continue;
+        }
+        if (kind == TOKEN_POSITIONAL)
+        {
+            if (positional)
+            {
+                positional(current);
+                continue;
+            }
+            if (this->variadic < 0 && this->stream_positionals.size() >= this->positionals.size())
+            {
+                result.error.assign("error: unexpected argument ");
+                util::append_value(result.error, current);
+                return false;
+            }
+            keep(current, this->stream_positionals);
+            continue;
+        }
+        if (!parse_option(current, kind, separator, result, next, store))
         {
-            key = name_query[flag];
+            return false;
         }
     }
-    
-    parameter* p_parameter = parameters[key];
-    if (p_parameter == nullptr)
+    if (tokens.failed())
+    {
+        result.error.assign("error: cannot read arguments");
+        return false;
+    }
+    const char* text = this->stream_values.data();
+    for (u64 n = 0; n < result.lists.size(); n++)
+    {
+        result.lists[n].text = std::string_view(text + this->stream_lists[n].offset, this->stream_lists[n].count);
+    }
+    if (!positional)
+    {
+        std::pmr::vector<std::string_view>& items = result.values.items;
+        u64 first = items.size();
+        for (const value_range& range : this->stream_positionals)
+        {
+            items.push_back(std::string_view(text + range.offset, range.count));
+        }
+        if (!assign_positionals(result, first, this->deferred_conversion))
+        {
+            return false;
+        }
+    }
+    return assign_lists(result);
+}
+
+bool parser::get_parameter_value_to(std::string_view flag, void* value_buf)
+{
+    i32 id = find_parameter(flag);
+    if (id < 0)
     {
         return false;
     }
-    p_parameter->get_value_to(value_buf);
+    assign_value(id);
+    parameters[id]->get_value_to(value_buf);
     return true;
 }
 
+i32 parser::find_parameter(std::string_view flag) const
+{
+    // Handle flags with dashes
+    if (!flag.empty() && flag[0] == '-')
+    {
+        flag.remove_prefix(1);
+        if (!flag.empty() && flag[0] == '-')
+        {
+            // Long name (--flag)
+            flag.remove_prefix(1);
+            return index.find_long(flag);
+        }
+        // Short name (-f)
+        return index.find_short(flag);
+    }
+
+    // No dashes - try short name first, then long name, then positionals
+    // and flag families
+    i32 id = index.find_short(flag);
+    if (id < 0)
+    {
+        id = index.find_long(flag);
+    }
+    for (u64 n = 0; id < 0 && n < this->positionals.size(); n++)
+    {
+        if (this->parameters[this->positionals[n]]->get_name() == flag)
+        {
+            id = this->positionals[n];
+        }
+    }
+    for (u64 n = 0; id < 0 && n < this->families.size(); n++)
+    {
+        if (this->parameters[this->families[n]]->get_name() == flag)
+        {
+            id = this->families[n];
+        }
+    }
+    return id;
+}
+
 void parser::set_auto_help(bool enable)
 {
     auto_help_enabled = enable;
 }
 
-bool parser::is_help_requested()
+void parser::set_deferred_conversion(bool enable)
 {
-    // Check if help parameter exists and is set
-    bool help_value = false;
-    if (get_parameter_value_to("h", &help_value) && help_value)
-    {
-        return true;
-    }
-    if (get_parameter_value_to("help", &help_value) && help_value)
+    deferred_conversion = enable;
+}
+
+bool parser::is_help_requested() const
+{
+    // Check if a help flag exists and is set
+    for (std::string_view flag : {std::string_view("h"), std::string_view("help")})
     {
-        return true;
+        i32 id = find_parameter(flag);
+        if (id < 0 || parameters[id]->get_type() != NONE)
+        {
+            continue;
+        }
+        bool help_value = false;
+        parameters[id]->get_value_to(&help_value);
+        if (help_value)
+        {
+            return true;
+        }
     }
     return false;
 }
@@ -0,0 +1,106 @@
+#include "argparse/process_scan.h"
+#include <cstdio>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace argparse;
+
+// Program name of a command line: its first argument without the directory
+static std::string_view program_of(std::string_view cmdline)
+{
+    std::string_view program = cmdline.substr(0, cmdline.find('\0'));
+    u64 last_slash = program.find_last_of('/');
+    if (last_slash != std::string_view::npos)
+    {
+        program.remove_prefix(last_slash + 1);
+    }
+    return program;
+}
+
+process_scan::process_scan(std::pmr::memory_resource* resource) : buffer(resource), offsets(resource), pids(resource)
+{
+    this->used = 0;
+}
+
+bool process_scan::scan(std::string_view program)
+{
+    this->used = 0;
+    this->offsets.assign(1, 0);
+    this->pids.clear();
+
+    DIR* dir = opendir("/proc");
+    if (dir == nullptr)
+    {
+        return false;
+    }
+    while (dirent* entry = readdir(dir))
+    {
+        i32 pid = 0;
+        const char* name = entry->d_name;
+        for (; *name >= '0' && *name <= '9'; name++)
+        {
+            pid = pid * 10 + (*name - '0');
+        }
+        if (*name != '\0' || pid == 0)
+        {
+            continue;
+        }
+
+        u64 start = this->used;
+        u64 length = read_cmdline(pid);
+        std::string_view cmdline(this->buffer.data() + start, length);
+        if (length == 0 || (!program.empty() && program_of(cmdline) != program))
+        {
+            this->used = start;
+            continue;
+        }
+        this->offsets.push_back(this->used);
+        this->pids.push_back(pid);
+    }
+    closedir(dir);
+    return true;
+}
+
+u64 process_scan::read_cmdline(i32 pid)
+{
+    char path[32];
+    std::snprintf(path, sizeof(path), "/proc/%d/cmdline", pid);
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        return 0;
+    }
+    u64 start = this->used;
+    while (true)
+    {
+        if (this->buffer.size() - this->used < 4096)
+        {
+            this->buffer.resize(this->buffer.size() * 2 + 4096);
+        }
+        ssize_t count = read(fd, this->buffer.data() + this->used, this->buffer.size() - this->used);
+        if (count <= 0)
+        {
+            break;
+        }
+        this->used += (u64)count;
+    }
+    close(fd);
+    return this->used - start;
+}
+
+u64 process_scan::size() const
+{
+    return this->pids.size();
+}
+
+i32 process_scan::get_pid(u64 row) const
+{
+    return this->pids[row];
+}
+
+std::string_view process_scan::get_cmdline(u64 row) const
+{
+    return std::string_view(this->buffer.data() + this->offsets[row], this->offsets[row + 1] - this->offsets[row]);
+}
@@ -0,0 +1,231 @@
+#include "argparse/response_files.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace argparse;
+
+static bool is_space(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+}
+
+response_files::response_files(std::pmr::memory_resource* resource) : files(resource), token_views(resource)
+{
+}
+
+response_files::~response_files()
+{
+    release();
+}
+
+bool response_files::expand(int argc, const char* const* argv)
+{
+    release();
+    for (int i = 0; i < argc; i++)
+    {
+        if (i == 0)
+        {
+            this->token_views.push_back(argv[i]);
+        }
+        else if (!expand_token(argv[i]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool response_files::expand(const std::vector<std::string>& args)
+{
+    release();
+    for (u64 i = 0; i < args.size(); i++)
+    {
+        if (i == 0)
+        {
+            this->token_views.push_back(args[i]);
+        }
+        else if (!expand_token(args[i]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+span<const std::string_view> response_files::tokens() const
+{
+    return span<const std::string_view>(this->token_views.data(), this->token_views.size());
+}
+
+const std::string& response_files::get_error() const
+{
+    return this->error;
+}
+
+bool response_files::expand_token(std::string_view token)
+{
+    if (token.size() > 1 && token[0] == '@')
+    {
+        return expand_file(token.substr(1));
+    }
+    this->token_views.push_back(token);
+    return true;
+}
+
+bool response_files::expand_file(std::string_view path)
+{
+    std::string name(path);
+    int fd = open(name.c_str(), O_RDONLY);
+    struct stat info;
+    if (fd < 0 || fstat(fd, &info) != 0)
+    {
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+        this->error.assign("error: cannot open response file ").append(path);
+        return false;
+    }
+
+    // a file seen before is either being expanded, which is a cycle, or done,
+    // in which case its tokens are repeated without mapping it again
+    for (const mapping& file : this->files)
+    {
+        if (file.device == (u64)info.st_dev && file.inode == (u64)info.st_ino)
+        {
+            close(fd);
+            if (file.expanding)
+            {
+                this->error.assign("error: response file ").append(path).append(" includes itself");
+                return false;
+            }
+            u64 first = file.first;
+            u64 count = file.count;
+            this->token_views.reserve(this->token_views.size() + count);
+            for (u64 i = 0; i < count; i++)
+            {
+                this->token_views.push_back(this->token_views[first + i]);
+            }
+            return true;
+        }
+    }
+
+    mapping file = {nullptr, (u64)info.st_size, (u64)info.st_dev, (u64)info.st_ino, this->token_views.size(), 0, true};
+    if (file.size > 0)
+    {
+        // private and writable: unquoting writes to copies of the touched
+        // pages only, the file itself is never modified
+        void* data = mmap(nullptr, file.size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED)
+        {
+            close(fd);
+            this->error.assign("error: cannot map response file ").append(path);
+            return false;
+        }
+        madvise(data, file.size, MADV_SEQUENTIAL);
+        file.data = (char*)data;
+    }
+    close(fd);
+
+    // nested files may grow files, so it is addressed by index from here on
+    u64 id = this->files.size();
+    this->files.push_back(file);
+    if (!tokenize(id, path))
+    {
+        return false;
+    }
+    this->files[id].count = this->token_views.size() - this->files[id].first;
+    this->files[id].expanding = false;
+    return true;
+}
+
+bool response_files::tokenize(u64 file, std::string_view path)
+{
+    char* data = this->files[file].data;
+    u64 size = this->files[file].size;
+    u64 at = 0;
+    while (true)
+    {
+        while (at < size && is_space(data[at]))
+        {
+            at++;
+        }
+        if (at >= size)
+        {
+            return true;
+        }
+
+        // the token is unquoted into its own place; bytes are only written
+        // once quotes or backslashes have been dropped, so that plain tokens
+        // leave their pages untouched
+        bool include = data[at] == '@';
+        char* start = data + at;
+        char* out = start;
+        auto keep = [&]()
+        {
+            if (out != data + at)
+            {
+                *out = data[at];
+            }
+            out++;
+            at++;
+        };
+        while (at < size && !is_space(data[at]))
+        {
+            char c = data[at];
+            if (c == '\'' || c == '"')
+            {
+                at++;
+                while (at < size && data[at] != c)
+                {
+                    if (c == '"' && data[at] == '\\' && at + 1 < size && (data[at + 1] == '"' || data[at + 1] == '\\'))
+                    {
+                        at++;
+                    }
+                    keep();
+                }
+                if (at >= size)
+                {
+                    this->error.assign("error: unterminated quote in response file ").append(path);
+                    return false;
+                }
+                at++;
+            }
+            else if (c == '\\' && at + 1 < size)
+            {
+                at++;
+                keep();
+            }
+            else
+            {
+                keep();
+            }
+        }
+
+        std::string_view token(start, (u64)(out - start));
+        if (include && !expand_token(token))
+        {
+            return false;
+        }
+        if (!include)
+        {
+            this->token_views.push_back(token);
+        }
+    }
+}
+
+void response_files::release()
+{
+    for (const mapping& file : this->files)
+    {
+        if (file.data != nullptr)
+        {
+            munmap(file.data, file.size);
+        }
+    }
+    this->files.clear();
+    this->token_views.clear();
+    this->error.clear();
+}
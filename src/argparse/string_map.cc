@@ -0,0 +1,67 @@
+#include "argparse/string_map.h"
+#include "argparse/hash.h"
+
+using namespace argparse;
+
+string_map::string_map() : items(nullptr), count(0), slots(nullptr), capacity(0)
+{
+}
+
+string_map::string_map(const map_entry* entries, u64 count, const u32* slots, u64 capacity)
+    : items(entries), count(count), slots(slots), capacity(capacity)
+{
+}
+
+u64 string_map::size() const
+{
+    return this->count;
+}
+
+bool string_map::empty() const
+{
+    return this->count == 0;
+}
+
+const std::string_view* string_map::find(std::string_view key) const
+{
+    if (this->count == 0)
+    {
+        return nullptr;
+    }
+    u64 h = hash(key);
+    u64 mask = this->capacity - 1;
+    for (u64 i = h & mask; ; i = (i + 1) & mask)
+    {
+        u32 number = this->slots[i];
+        if (number == 0)
+        {
+            return nullptr;
+        }
+        const map_entry& entry = this->items[number - 1];
+        if (entry.hash == h && entry.key == key)
+        {
+            return &entry.value;
+        }
+    }
+}
+
+bool string_map::contains(std::string_view key) const
+{
+    return find(key) != nullptr;
+}
+
+std::string_view string_map::get(std::string_view key, std::string_view fallback) const
+{
+    const std::string_view* value = find(key);
+    return value != nullptr ? *value : fallback;
+}
+
+span<const map_entry> string_map::entries() const
+{
+    return span<const map_entry>(this->items, this->count);
+}
+
+u64 string_map::hash(std::string_view key)
+{
+    return fnv1a(key);
+}
\ No newline at end of file
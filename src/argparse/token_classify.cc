@@ -0,0 +1,37 @@
+#include "argparse/token_classify.h"
+
+using namespace argparse;
+
+token_kind argparse::classify_token(std::string_view token, u32& separator)
+{
+    // a lone "-" names standard input, as a value or an argument
+    if (token.size() < 2 || token[0] != '-')
+    {
+        return TOKEN_POSITIONAL;
+    }
+    if (token[1] != '-')
+    {
+        return TOKEN_SHORT;
+    }
+    if (token.size() == 2)
+    {
+        return TOKEN_TERMINATOR;
+    }
+    u64 equals = token.find('=', 2);
+    if (equals != std::string_view::npos)
+    {
+        separator = (u32)equals;
+        return TOKEN_LONG_VALUE;
+    }
+    return TOKEN_LONG;
+}
+
+bool argparse::is_negative_number(std::string_view token)
+{
+    if (token.size() < 2 || token[0] != '-')
+    {
+        return false;
+    }
+    u64 digit = token[1] == '.' ? 2 : 1;
+    return digit < token.size() && token[digit] >= '0' && token[digit] <= '9';
+}
\ No newline at end of file
@@ -0,0 +1,93 @@
+#include "argparse/token_list.h"
+#include <algorithm>
+#include <cstring>
+
+using namespace argparse;
+
+token_list::token_list(int argc, const char* const* argv)
+{
+    this->argv = argv;
+    this->strings = nullptr;
+    this->views = nullptr;
+    this->delimiter = '\0';
+    this->count = argc > 0 ? (u64)argc : 0;
+    this->cursor_index = 0;
+    this->cursor_offset = 0;
+}
+
+token_list::token_list(const std::vector<std::string>& args)
+{
+    this->argv = nullptr;
+    this->strings = args.data();
+    this->views = nullptr;
+    this->delimiter = '\0';
+    this->count = args.size();
+    this->cursor_index = 0;
+    this->cursor_offset = 0;
+}
+
+token_list::token_list(span<const std::string_view> args)
+{
+    this->argv = nullptr;
+    this->strings = nullptr;
+    this->views = args.data();
+    this->delimiter = '\0';
+    this->count = args.size();
+    this->cursor_index = 0;
+    this->cursor_offset = 0;
+}
+
+token_list::token_list(std::string_view buffer, char delimiter)
+{
+    this->argv = nullptr;
+    this->strings = nullptr;
+    this->views = nullptr;
+    this->buffer = buffer;
+    this->delimiter = delimiter;
+    this->count = (u64)std::count(buffer.begin(), buffer.end(), delimiter);
+    if (!buffer.empty() && buffer.back() != delimiter)
+    {
+        this->count++;
+    }
+    this->cursor_index = 0;
+    this->cursor_offset = 0;
+}
+
+u64 token_list::size() const
+{
+    return this->count;
+}
+
+std::string_view token_list::operator[](u64 index) const
+{
+    if (this->strings != nullptr)
+    {
+        return this->strings[index];
+    }
+    if (this->views != nullptr)
+    {
+        return this->views[index];
+    }
+    if (this->argv != nullptr)
+    {
+        return std::string_view(this->argv[index]);
+    }
+
+    // walk forward from the last token accessed, or from the start
+    if (index < this->cursor_index)
+    {
+        this->cursor_index = 0;
+        this->cursor_offset = 0;
+    }
+    const char* data = this->buffer.data();
+    u64 size = this->buffer.size();
+    while (this->cursor_index < index)
+    {
+        const void* end = std::memchr(data + this->cursor_offset, this->delimiter, size - this->cursor_offset);
+        this->cursor_offset = (u64)((const char*)end - data) + 1;
+        this->cursor_index++;
+    }
+    const void* end = std::memchr(data + this->cursor_offset, this->delimiter, size - this->cursor_offset);
+    u64 length = end != nullptr ? (u64)((const char*)end - data) - this->cursor_offset : size - this->cursor_offset;
+    return std::string_view(data + this->cursor_offset, length);
+}
\ No newline at end of file
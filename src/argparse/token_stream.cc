@@ -0,0 +1,105 @@
+#include "argparse/token_stream.h"
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+
+using namespace argparse;
+
+token_stream::token_stream(int fd, char delimiter, u64 chunk_size, std::pmr::memory_resource* resource) : buffer(chunk_size > 0 ? chunk_size : 1, resource)
+{
+    this->fd = fd;
+    this->in = nullptr;
+    this->delimiter = delimiter;
+    this->begin = 0;
+    this->scan = 0;
+    this->end = 0;
+    this->at_end = false;
+    this->read_failed = false;
+}
+
+token_stream::token_stream(std::istream& in, char delimiter, u64 chunk_size, std::pmr::memory_resource* resource) : buffer(chunk_size > 0 ? chunk_size : 1, resource)
+{
+    this->fd = -1;
+    this->in = &in;
+    this->delimiter = delimiter;
+    this->begin = 0;
+    this->scan = 0;
+    this->end = 0;
+    this->at_end = false;
+    this->read_failed = false;
+}
+
+bool token_stream::next(std::string_view& token)
+{
+    while (true)
+    {
+        char* data = this->buffer.data();
+        const void* found = std::memchr(data + this->scan, this->delimiter, this->end - this->scan);
+        if (found != nullptr)
+        {
+            u64 stop = (u64)((const char*)found - data);
+            token = std::string_view(data + this->begin, stop - this->begin);
+            this->begin = stop + 1;
+            this->scan = this->begin;
+            return true;
+        }
+        this->scan = this->end;
+        if (this->at_end)
+        {
+            if (this->begin == this->end)
+            {
+                return false;
+            }
+            token = std::string_view(data + this->begin, this->end - this->begin);
+            this->begin = this->end;
+            return true;
+        }
+        fill();
+    }
+}
+
+bool token_stream::failed() const
+{
+    return this->read_failed;
+}
+
+void token_stream::fill()
+{
+    // keep the unfinished token, moved to the front
+    if (this->begin > 0)
+    {
+        std::memmove(this->buffer.data(), this->buffer.data() + this->begin, this->end - this->begin);
+        this->scan -= this->begin;
+        this->end -= this->begin;
+        this->begin = 0;
+    }
+    if (this->end == this->buffer.size())
+    {
+        this->buffer.resize(this->buffer.size() * 2);
+    }
+
+    char* target = this->buffer.data() + this->end;
+    u64 space = this->buffer.size() - this->end;
+    i64 count = 0;
+    if (this->in != nullptr)
+    {
+        this->in->read(target, (std::streamsize)space);
+        count = (i64)this->in->gcount();
+        this->read_failed = count == 0 && this->in->bad();
+    }
+    else
+    {
+        do
+        {
+            count = (i64)read(this->fd, target, space);
+        } while (count < 0 && errno == EINTR);
+        this->read_failed = count < 0;
+    }
+
+    if (count <= 0)
+    {
+        this->at_end = true;
+        return;
+    }
+    this->end += (u64)count;
+}
@@ -1,8 +1,9 @@
 #include "argparse/util.h"
+#include <new>
 
 using namespace argparse;
 
-parameter* util::create_parameter(std::string short_name, std::string name, std::string description, parameter_type type)
+parameter* util::create_parameter(std::string_view short_name, std::string_view name, std::string_view description, parameter_type type)
 {
     switch (type)
     {
@@ -14,8 +15,105 @@ parameter* util::create_parameter(std::string short_name, std::string name, std:
         return new parameter_string(short_name, name, description);
     case parameter_type::FLOAT:
         return new parameter_float(short_name, name, description);
+    case parameter_type::STRING_LIST:
+        return new parameter_string_list(short_name, name, description);
+    case parameter_type::INTEGER_LIST:
+        return new parameter_integer_list(short_name, name, description);
+    case parameter_type::FLOAT_LIST:
+        return new parameter_float_list(short_name, name, description);
+    case parameter_type::STRING_MAP:
+        return new parameter_string_map(short_name, name, description);
+    case parameter_type::FLAG_SET:
+        return new parameter_flag_set(short_name, name, description);
     default:
         std::cerr << "Unknown parameter type: " << type << std::endl;
         return nullptr;
     }
+}
+
+template<typename T, typename... A>
+static parameter* construct_in(std::pmr::memory_resource* resource, A... args)
+{
+    void* p_memory = resource->allocate(sizeof(T), alignof(T));
+    return new (p_memory) T(args..., resource);
+}
+
+template<typename T>
+static void destroy_in(parameter* p_parameter, std::pmr::memory_resource* resource)
+{
+    p_parameter->~parameter();
+    resource->deallocate(p_parameter, sizeof(T), alignof(T));
+}
+
+parameter* util::create_parameter(std::string_view short_name, std::string_view name, std::string_view description, parameter_type type, std::pmr::memory_resource* resource)
+{
+    switch (type)
+    {
+    case parameter_type::NONE:
+        return construct_in<parameter_none>(resource, short_name, name, description);
+    case parameter_type::INTEGER:
+        return construct_in<parameter_integer>(resource, short_name, name, description, 10, true);
+    case parameter_type::STRING:
+        return construct_in<parameter_string>(resource, short_name, name, description);
+    case parameter_type::FLOAT:
+        return construct_in<parameter_float>(resource, short_name, name, description);
+    case parameter_type::STRING_LIST:
+        return construct_in<parameter_string_list>(resource, short_name, name, description);
+    case parameter_type::INTEGER_LIST:
+        return construct_in<parameter_integer_list>(resource, short_name, name, description);
+    case parameter_type::FLOAT_LIST:
+        return construct_in<parameter_float_list>(resource, short_name, name, description);
+    case parameter_type::STRING_MAP:
+        return construct_in<parameter_string_map>(resource, short_name, name, description);
+    case parameter_type::FLAG_SET:
+        return construct_in<parameter_flag_set>(resource, short_name, name, description);
+    default:
+        std::cerr << "Unknown parameter type: " << type << std::endl;
+        return nullptr;
+    }
+}
+
+void util::destroy_parameter(parameter* p_parameter, std::pmr::memory_resource* resource)
+{
+    switch (p_parameter->get_type())
+    {
+    case parameter_type::NONE:
+        destroy_in<parameter_none>(p_parameter, resource);
+        break;
+    case parameter_type::INTEGER:
+        destroy_in<parameter_integer>(p_parameter, resource);
+        break;
+    case parameter_type::STRING:
+        destroy_in<parameter_string>(p_parameter, resource);
+        break;
+    case parameter_type::FLOAT:
+        destroy_in<parameter_float>(p_parameter, resource);
+        break;
+    case parameter_type::STRING_LIST:
+        destroy_in<parameter_string_list>(p_parameter, resource);
+        break;
+    case parameter_type::INTEGER_LIST:
+        destroy_in<parameter_integer_list>(p_parameter, resource);
+        break;
+    case parameter_type::FLOAT_LIST:
+        destroy_in<parameter_float_list>(p_parameter, resource);
+        break;
+    case parameter_type::STRING_MAP:
+        destroy_in<parameter_string_map>(p_parameter, resource);
+        break;
+    case parameter_type::FLAG_SET:
+        destroy_in<parameter_flag_set>(p_parameter, resource);
+        break;
+    }
+}
+
+void util::append_value(std::string& message, std::string_view value)
+{
+    const u64 limit = 80;
+    if (value.size() <= limit)
+    {
+        message.append(value.data(), value.size());
+        return;
+    }
+    message.append(value.data(), limit).append("...");
 }
\ No newline at end of file
@@ -0,0 +1,221 @@
+#include "argparse/value_table.h"
+
+using namespace argparse;
+
+namespace
+{
+    // Drop the elements appended after the first size, never allocating
+    template<typename T>
+    void truncate(std::pmr::vector<T>& items, u64 size)
+    {
+        items.erase(items.begin() + size, items.end());
+    }
+}
+
+value_table::value_table(std::pmr::memory_resource* resource) : states(resource), cells(resource), texts(resource), items(resource), integer_items(resource), real_items(resource), map_entries(resource), map_slots(resource), flag_words(resource), touched(resource)
+{
+}
+
+u64 value_table::size() const
+{
+    return this->states.size();
+}
+
+void value_table::push_back()
+{
+    this->states.push_back(0);
+    this->cells.push_back(value_cell());
+    this->texts.push_back(std::string_view());
+}
+
+void value_table::reset(i32 id)
+{
+    this->states[id] = 0;
+    this->cells[id] = value_cell();
+    this->texts[id] = std::string_view();
+}
+
+void value_table::assign(const value_table& other)
+{
+    this->states.assign(other.states.begin(), other.states.end());
+    this->cells.assign(other.cells.begin(), other.cells.end());
+    this->texts.assign(other.texts.begin(), other.texts.end());
+    this->items.assign(other.items.begin(), other.items.end());
+    this->integer_items.assign(other.integer_items.begin(), other.integer_items.end());
+    this->real_items.assign(other.real_items.begin(), other.real_items.end());
+    this->map_entries.assign(other.map_entries.begin(), other.map_entries.end());
+    this->map_slots.assign(other.map_slots.begin(), other.map_slots.end());
+    this->flag_words.assign(other.flag_words.begin(), other.flag_words.end());
+    this->touched.clear();
+}
+
+void value_table::touch(i32 id)
+{
+    if (!(this->states[id] & TOUCHED))
+    {
+        this->states[id] |= TOUCHED;
+        this->touched.push_back(id);
+    }
+}
+
+void value_table::restore(const value_table& other)
+{
+    for (i32 id : this->touched)
+    {
+        this->states[id] = other.states[id];
+        this->cells[id] = other.cells[id];
+        this->texts[id] = other.texts[id];
+    }
+    this->touched.clear();
+    truncate(this->items, other.items.size());
+    truncate(this->integer_items, other.integer_items.size());
+    truncate(this->real_items, other.real_items.size());
+    truncate(this->map_entries, other.map_entries.size());
+    truncate(this->map_slots, other.map_slots.size());
+    truncate(this->flag_words, other.flag_words.size());
+}
+
+value_slot value_table::get_slot(i32 id, parameter_type type) const
+{
+    value_slot slot = value_slot();
+    slot.present = (this->states[id] & PRESENT) != 0;
+    switch (type)
+    {
+    case NONE:
+        slot.flag = this->cells[id].flag;
+        break;
+    case INTEGER:
+        slot.integer = this->cells[id].integer;
+        break;
+    case FLOAT:
+        slot.real = this->cells[id].real;
+        break;
+    case STRING:
+        slot.text = this->texts[id];
+        break;
+    case STRING_LIST:
+        slot.items = span<const std::string_view>(this->items.data() + this->cells[id].range.offset, this->cells[id].range.count);
+        break;
+    case INTEGER_LIST:
+        slot.integers = span<const i64>(this->integer_items.data() + this->cells[id].range.offset, this->cells[id].range.count);
+        break;
+    case FLOAT_LIST:
+        slot.reals = span<const f64>(this->real_items.data() + this->cells[id].range.offset, this->cells[id].range.count);
+        break;
+    case STRING_MAP:
+        slot.map = map(id);
+        break;
+    case FLAG_SET:
+        slot.flags = flags(id);
+        break;
+    }
+    return slot;
+}
+
+void value_table::set_slot(i32 id, parameter_type type, const value_slot& slot)
+{
+    u8 touched = this->states[id] & TOUCHED;
+    reset(id);
+    this->states[id] = (slot.present ? PRESENT : 0) | touched;
+    switch (type)
+    {
+    case NONE:
+        this->cells[id].flag = slot.flag;
+        break;
+    case INTEGER:
+        this->cells[id].integer = slot.integer;
+        break;
+    case FLOAT:
+        this->cells[id].real = slot.real;
+        break;
+    case STRING:
+        this->texts[id] = slot.text;
+        break;
+    case STRING_LIST:
+        this->cells[id].range.offset = (u32)this->items.size();
+        this->cells[id].range.count = (u32)slot.items.size();
+        this->items.insert(this->items.end(), slot.items.begin(), slot.items.end());
+        break;
+    case INTEGER_LIST:
+        this->cells[id].range.offset = (u32)this->integer_items.size();
+        this->cells[id].range.count = (u32)slot.integers.size();
+        this->integer_items.insert(this->integer_items.end(), slot.integers.begin(), slot.integers.end());
+        break;
+    case FLOAT_LIST:
+        this->cells[id].range.offset = (u32)this->real_items.size();
+        this->cells[id].range.count = (u32)slot.reals.size();
+        this->real_items.insert(this->real_items.end(), slot.reals.begin(), slot.reals.end());
+        break;
+    case STRING_MAP:
+        if (!slot.map.empty())
+        {
+            begin_map(id, slot.map.size());
+            for (const map_entry& entry : slot.map.entries())
+            {
+                define(id, entry.key, entry.value);
+            }
+        }
+        break;
+    case FLAG_SET:
+        this->cells[id].range.offset = (u32)this->flag_words.size();
+        this->cells[id].range.count = (u32)slot.flags.size();
+        this->flag_words.insert(this->flag_words.end(), slot.flags.words().begin(), slot.flags.words().end());
+        break;
+    }
+}
+
+void value_table::begin_map(i32 id, u64 count)
+{
+    // at most half full, so that probes stay short
+    u64 capacity = 2;
+    while (capacity < 2 * count)
+    {
+        capacity *= 2;
+    }
+    value_range& range = this->cells[id].range;
+    range.offset = (u32)this->map_slots.size();
+    range.count = 0;
+    this->map_slots.push_back((u32)this->map_entries.size());
+    this->map_slots.push_back((u32)capacity);
+    this->map_slots.resize(this->map_slots.size() + capacity, 0);
+}
+
+void value_table::define(i32 id, std::string_view key, std::string_view value)
+{
+    value_range& range = this->cells[id].range;
+    u32 first = this->map_slots[range.offset];
+    u64 mask = this->map_slots[range.offset + 1] - 1;
+    u32* slots = this->map_slots.data() + range.offset + 2;
+    u64 h = string_map::hash(key);
+    for (u64 i = h & mask; ; i = (i + 1) & mask)
+    {
+        if (slots[i] == 0)
+        {
+            this->map_entries.push_back(map_entry{h, key, value});
+            slots[i] = ++range.count;
+            return;
+        }
+        map_entry& entry = this->map_entries[first + slots[i] - 1];
+        if (entry.hash == h && entry.key == key)
+        {
+            entry.value = value;
+            return;
+        }
+    }
+}
+
+string_map value_table::map(i32 id) const
+{
+    value_range range = this->cells[id].range;
+    if (range.count == 0)
+    {
+        return string_map();
+    }
+    const u32* block = this->map_slots.data() + range.offset;
+    return string_map(this->map_entries.data() + block[0], range.count, block + 2, block[1]);
+}
+
+flag_set value_table::flags(i32 id) const
+{
+    return flag_set(this->flag_words.data() + this->cells[id].range.offset, this->cells[id].range.count);
+}
\ No newline at end of file
@@ -0,0 +1,92 @@
+#include "allocation_counter.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+static std::atomic<long long> allocations(0);
+static std::atomic<long long> bytes(0);
+static std::atomic<long long> deallocations(0);
+
+long long allocation_count() {
+    return allocations.load(std::memory_order_relaxed);
+}
+
+long long allocated_bytes() {
+    return bytes.load(std::memory_order_relaxed);
+}
+
+long long deallocation_count() {
+    return deallocations.load(std::memory_order_relaxed);
+}
+
+static void deallocate(void* p) {
+    if (p != nullptr) {
+        deallocations.fetch_add(1, std::memory_order_relaxed);
+    }
+    std::free(p);
+}
+
+static void* allocate(std::size_t size, std::size_t alignment) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    bytes.fetch_add((long long)size, std::memory_order_relaxed);
+    if (size == 0) {
+        size = 1;
+    }
+    void* p = alignment <= alignof(std::max_align_t)
+        ? std::malloc(size)
+        : std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void* operator new(std::size_t size) {
+    return allocate(size, alignof(std::max_align_t));
+}
+
+void* operator new[](std::size_t size) {
+    return allocate(size, alignof(std::max_align_t));
+}
+
+// std::pmr::new_delete_resource allocates through the aligned overloads
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    return allocate(size, (std::size_t)alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return allocate(size, (std::size_t)alignment);
+}
+
+void operator delete(void* p) noexcept {
+    deallocate(p);
+}
+
+void operator delete[](void* p) noexcept {
+    deallocate(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    deallocate(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+    deallocate(p);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept {
+    deallocate(p);
+}
+
+void operator delete[](void* p, std::align_val_t) noexcept {
+    deallocate(p);
+}
+
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept {
+    deallocate(p);
+}
+
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept {
+    deallocate(p);
+}
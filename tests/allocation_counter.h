@@ -0,0 +1,28 @@
+#ifndef ALLOCATION_COUNTER_H
+#define ALLOCATION_COUNTER_H
+
+#include "test_framework.h"
+
+// Linking allocation_counter.cc replaces the global operator new and delete of
+// a test executable, so tests can assert how often a statement allocates
+
+// Heap allocations and bytes requested since the program started
+long long allocation_count();
+long long allocated_bytes();
+// Heap blocks freed since the program started
+long long deallocation_count();
+
+#define ASSERT_ALLOCATIONS(expected, ...) \
+    do { \
+        long long allocations_before = allocation_count(); \
+        __VA_ARGS__; \
+        long long allocations_made = allocation_count() - allocations_before; \
+        if (allocations_made != (expected)) { \
+            std::cerr << "ASSERTION FAILED: " << #__VA_ARGS__ << " made " << allocations_made << " allocations, expected " << (expected) << " at " << __FILE__ << ":" << __LINE__ << std::endl; \
+            return false; \
+        } \
+    } while(0)
+
+#define ASSERT_NO_ALLOCATIONS(...) ASSERT_ALLOCATIONS(0, __VA_ARGS__)
+
+#endif
@@ -0,0 +1,182 @@
+#include "allocation_counter.h"
+#include "test_fixtures.h"
+#include "argparse/parser.h"
+#include "argparse/schema.h"
+#include <string>
+#include <vector>
+
+using namespace argparse;
+
+// Test that the counter sees allocations at all
+bool test_counter_counts() {
+    ASSERT_ALLOCATIONS(1, int* volatile p = new int(7); delete p);
+    long long bytes = allocated_bytes();
+    std::string* volatile text = new std::string(200, 'x');
+    ASSERT_TRUE(allocated_bytes() - bytes >= 200);
+    delete text;
+    
+    return true;
+}
+
+// Test that parsing 100 flags with a frozen spec into a reused result does not allocate
+bool test_frozen_flag_parse() {
+    parser p;
+    p.set_auto_help(false);
+    std::vector<std::string> names;
+    for (int i = 0; i < 100; i++) {
+        names.push_back("flag-" + std::to_string(i));
+    }
+    for (const std::string& name : names) {
+        p.add_parameter("", name, "A flag", NONE);
+    }
+    p.freeze();
+    
+    std::vector<std::string> tokens = {"program"};
+    for (const std::string& name : names) {
+        tokens.push_back("--" + name);
+    }
+    std::vector<const char*> argv = pointers(tokens);
+    
+    parse_result result;
+    ASSERT_TRUE(p.parse((int)argv.size(), argv.data(), result));
+    bool ok = false;
+    ASSERT_NO_ALLOCATIONS(ok = p.parse((int)argv.size(), argv.data(), result));
+    ASSERT_TRUE(ok);
+    
+    bool flag = false;
+    ASSERT_TRUE(result.get_parameter_value_to("flag-99", &flag));
+    ASSERT_TRUE(flag);
+    
+    return true;
+}
+
+// Test that the stateful parse does not allocate once the parser has been used
+bool test_stateful_parse() {
+    parser p;
+    p.set_auto_help(false);
+    p.add_parameter("v", "verbose", "Verbose mode", NONE);
+    p.add_parameter("n", "number", "A number", INTEGER, false, "1");
+    p.add_parameter("r", "rate", "A rate", FLOAT, false, "0.5");
+    p.add_parameter("f", "file", "Input file", STRING, false, "default.txt");
+    p.add_parameter("", "a-rather-long-option-name", "A long option", NONE);
+    
+    char program[] = "program";
+    char verbose[] = "-v";
+    char number[] = "--number";
+    char value[] = "42";
+    char file[] = "-f";
+    char path[] = "a/path/that/is/longer/than/the/small/string/buffer.txt";
+    char option[] = "--a-rather-long-option-name";
+    char* argv[] = {program, verbose, number, value, file, path, option};
+    std::vector<std::string> args(argv, argv + 7);
+    ASSERT_TRUE(p.parse(7, argv));
+    
+    bool ok = false;
+    ASSERT_NO_ALLOCATIONS(ok = p.parse(7, argv));
+    ASSERT_TRUE(ok);
+    ASSERT_NO_ALLOCATIONS(ok = p.parse(args));
+    ASSERT_TRUE(ok);
+    
+    i64 n = 0;
+    p.get_parameter_value_to("n", &n);
+    ASSERT_EQ(42, n);
+    
+    return true;
+}
+
+// Test that reading values does not allocate
+bool test_read_values() {
+    parser p;
+    p.set_auto_help(false);
+    handle<i64> count = p.add_parameter<i64>("n", "number", "A number", false, "5");
+    handle<f64> rate = p.add_parameter<f64>("r", "rate", "A rate", false, "0.5");
+    handle<bool> verbose = p.add_parameter<bool>("v", "verbose", "Verbose mode");
+    p.freeze();
+    
+    const char* argv[] = {"program", "-n", "12", "-v"};
+    parse_result result;
+    ASSERT_TRUE(p.parse(4, argv, result));
+    ASSERT_TRUE(p.parse(std::vector<std::string>{"program", "-n", "12"}));
+    
+    i64 integer = 0;
+    ASSERT_NO_ALLOCATIONS(p.get_parameter_value_to("number", &integer));
+    ASSERT_EQ(12, integer);
+    ASSERT_NO_ALLOCATIONS(integer = p.get(count));
+    ASSERT_EQ(12, integer);
+    ASSERT_NO_ALLOCATIONS(integer = result.get(count));
+    ASSERT_EQ(12, integer);
+    ASSERT_NO_ALLOCATIONS(result.get_parameter_value_to("-n", &integer));
+    ASSERT_EQ(12, integer);
+    
+    f64 real = 0.0;
+    ASSERT_NO_ALLOCATIONS(real = result.get(rate));
+    ASSERT_EQ(0.5, real);
+    bool flag = false;
+    ASSERT_NO_ALLOCATIONS(flag = result.get(verbose));
+    ASSERT_TRUE(flag);
+    
+    return true;
+}
+
+// Test that deferred values are converted on read without allocating
+bool test_deferred_read() {
+    parser p;
+    p.set_auto_help(false);
+    p.set_deferred_conversion(true);
+    handle<i64> count = p.add_parameter<i64>("n", "number", "A number", false, "5");
+    handle<std::string> file = p.add_parameter<std::string>("f", "file", "Input file", false, "none");
+    p.freeze();
+    
+    const char* argv[] = {"program", "-n", "77", "-f", "out.txt"};
+    parse_result result;
+    ASSERT_TRUE(p.parse(5, argv, result));
+    ASSERT_TRUE(p.parse(5, argv, result));
+    
+    i64 integer = 0;
+    ASSERT_NO_ALLOCATIONS(integer = result.get(count));
+    ASSERT_EQ(77, integer);
+    std::string_view text;
+    ASSERT_NO_ALLOCATIONS(text = result.get(file));
+    ASSERT_STREQ("out.txt", text);
+    
+    return true;
+}
+
+// Test that a compile-time schema parses without allocating
+struct schema_values {
+    bool verbose = false;
+    i64 count = 1;
+    std::string_view file;
+};
+
+bool test_schema_parse() {
+    static constexpr auto spec = make_schema(
+        option("v", "verbose", "Verbose mode", &schema_values::verbose),
+        option("n", "count", "A count", &schema_values::count),
+        option("f", "file", "Input file", &schema_values::file));
+    
+    const char* argv[] = {"program", "--verbose", "-n", "9", "--file", "x.txt"};
+    schema_values values;
+    bool ok = false;
+    ASSERT_NO_ALLOCATIONS(ok = spec.parse(6, argv, values));
+    ASSERT_TRUE(ok);
+    ASSERT_EQ(9, values.count);
+    
+    return true;
+}
+
+// Main test runner
+int main() {
+    std::cout << "Running allocation tests..." << std::endl;
+    
+    RUN_TEST(test_counter_counts);
+    RUN_TEST(test_frozen_flag_parse);
+    RUN_TEST(test_stateful_parse);
+    RUN_TEST(test_read_values);
+    RUN_TEST(test_deferred_read);
+    RUN_TEST(test_schema_parse);
+    
+    print_test_summary();
+    
+    return tests_failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,136 @@
+#include "allocation_counter.h"
+#include "test_fixtures.h"
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+using namespace argparse;
+
+// Memory resource that counts the blocks it hands out
+class counting_resource : public std::pmr::memory_resource {
+public:
+    long long allocations = 0;
+    long long live = 0;
+    
+private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        allocations++;
+        live++;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+    
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+        live--;
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+    
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+// Test that a parser on a fixed buffer never touches the heap
+bool test_arena_parser_does_not_allocate() {
+    alignas(std::max_align_t) static char buffer[64 * 1024];
+    const char* argv[] = {"/usr/bin/tool", "-v", "--number", "42", "-f", "data.csv", "-lvl", "7"};
+    
+    long long before = allocation_count();
+    {
+        std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer), std::pmr::null_memory_resource());
+        parser p(&arena);
+        add_test_options(p);
+        ASSERT_TRUE(p.parse(8, (char**)argv));
+        
+        i64 number = 0;
+        p.get_parameter_value_to("number", &number);
+        ASSERT_EQ(42, number);
+        
+        parse_result result(&arena);
+        ASSERT_TRUE(p.parse(8, argv, result));
+        i64 level = 0;
+        result.get_parameter_value_to("-lvl", &level);
+        ASSERT_EQ(7, level);
+    }
+    ASSERT_EQ(0, allocation_count() - before);
+    
+    return true;
+}
+
+// Test that all memory comes from the resource and is returned to it
+bool test_parser_uses_resource() {
+    counting_resource resource;
+    {
+        parser p(&resource);
+        add_test_options(p);
+        // replacing an option releases the old one
+        p.add_parameter("n", "number", "Number of iterations to run before stopping", INTEGER, false, "20");
+        ASSERT_TRUE(resource.allocations > 0);
+        ASSERT_TRUE(p.parse(std::vector<std::string>{"tool", "-v"}));
+    }
+    ASSERT_EQ(0, resource.live);
+    
+    return true;
+}
+
+// Test that an arena-backed parser behaves like a default one
+bool test_arena_matches_default() {
+    std::pmr::monotonic_buffer_resource arena;
+    parser on_arena(&arena);
+    parser on_heap;
+    add_test_options(on_arena);
+    add_test_options(on_heap);
+    ASSERT_STREQ(on_heap.get_help_message(), on_arena.get_help_message());
+    
+    std::vector<std::string> args = {"tool", "--rate", "2.5", "--a-rather-long-option-name"};
+    ASSERT_TRUE(on_arena.parse(args));
+    ASSERT_TRUE(on_heap.parse(args));
+    
+    f64 rate = 0.0;
+    on_arena.get_parameter_value_to("r", &rate);
+    ASSERT_EQ(2.5, rate);
+    std::string file;
+    on_arena.get_parameter_value_to("--file", &file);
+    ASSERT_STREQ("input.txt", file);
+    bool flag = false;
+    on_arena.get_parameter_value_to("a-rather-long-option-name", &flag);
+    ASSERT_TRUE(flag);
+    
+    return true;
+}
+
+// Test that an arena-backed parser still frees the heap memory of its string
+// and list options, while the arena takes back the rest at once
+bool test_arena_parser_frees_heap_values() {
+    std::vector<std::string> args = {"tool", "-f", "a/path/too/long/for/the/small/string/buffer.csv", "-I", "include", "-N", "1"};
+    long long live = allocation_count() - deallocation_count();
+    {
+        std::pmr::monotonic_buffer_resource arena;
+        parser p(&arena);
+        add_test_options(p);
+        p.add_parameter<std::vector<std::string_view>>("I", "include", "Include directory");
+        p.add_parameter<std::vector<i64>>("N", "numbers", "Numbers");
+        p.add_parameter<std::vector<f64>>("R", "rates", "Rates");
+        p.add_parameter<string_map>("D", "define", "Definition");
+        ASSERT_TRUE(p.parse(args));
+        std::string file;
+        p.get_parameter_value_to("file", &file);
+        ASSERT_STREQ(args[2], file);
+    }
+    ASSERT_EQ(live, allocation_count() - deallocation_count());
+    
+    return true;
+}
+
+// Main test runner
+int main() {
+    std::cout << "Running arena tests..." << std::endl;
+    
+    RUN_TEST(test_arena_parser_does_not_allocate);
+    RUN_TEST(test_parser_uses_resource);
+    RUN_TEST(test_arena_matches_default);
+    RUN_TEST(test_arena_parser_frees_heap_values);
+    
+    print_test_summary();
+    
+    return tests_failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,161 @@
+#include "test_framework.h"
+#include "argparse/parser.h"
+#include <string>
+#include <vector>
+
+using namespace argparse;
+
+// Owns the strings and argv arrays of a generated batch
+struct batch_input {
+    std::vector<std::vector<std::string>> lines;
+    std::vector<std::vector<const char*>> pointers;
+    std::vector<arg_vector> inputs;
+    
+    void add(std::vector<std::string> line) {
+        lines.push_back(std::move(line));
+    }
+    
+    void finish() {
+        pointers.clear();
+        inputs.clear();
+        for (auto& line : lines) {
+            std::vector<const char*> argv;
+            for (auto& token : line) {
+                argv.push_back(token.c_str());
+            }
+            pointers.push_back(argv);
+        }
+        for (auto& argv : pointers) {
+            inputs.push_back(arg_vector{(int)argv.size(), argv.data()});
+        }
+    }
+};
+
+// Builds rows where every 7th row is invalid
+static batch_input make_batch(int rows) {
+    batch_input batch;
+    for (int i = 0; i < rows; i++) {
+        if (i % 7 == 3) {
+            batch.add({"tool", "--bogus", std::to_string(i)});
+        } else if (i % 2 == 0) {
+            batch.add({"tool", "-n", std::to_string(i), "-f", "file" + std::to_string(i), "-v"});
+        } else {
+            batch.add({"tool", "--rate", std::to_string(i) + ".5"});
+        }
+    }
+    batch.finish();
+    return batch;
+}
+
+// Test columns, errors and defaults of a batch
+bool test_batch_columns() {
+    parser p;
+    handle<i64> number = p.add_parameter<i64>("n", "number", "A number", false, "-1");
+    handle<f64> rate = p.add_parameter<f64>("r", "rate", "A rate", false, "0.25");
+    handle<std::string> file = p.add_parameter<std::string>("f", "file", "Input file", false, "none");
+    handle<bool> verbose = p.add_parameter<bool>("v", "verbose", "Verbose mode");
+    
+    const int rows = 10000;
+    batch_input batch = make_batch(rows);
+    batch_result results;
+    ASSERT_FALSE(p.parse_batch(batch.inputs, results, 4));
+    ASSERT_EQ((u64)rows, results.size());
+    
+    span<const i64> numbers = results.column(number);
+    span<const f64> rates = results.column(rate);
+    span<const std::string_view> files = results.column(file);
+    span<const u8> flags = results.column(verbose);
+    span<const u8> number_given = results.is_set(number);
+    ASSERT_EQ((u64)rows, numbers.size());
+    
+    u64 failures = 0;
+    for (int i = 0; i < rows; i++) {
+        if (i % 7 == 3) {
+            failures++;
+            ASSERT_FALSE(results.succeeded(i));
+            ASSERT_TRUE(results.get_error(i) == "error: unknown parameter bogus");
+            ASSERT_EQ(-1, numbers[i]);
+            ASSERT_TRUE(files[i] == "none");
+            ASSERT_EQ(0, number_given[i]);
+        } else if (i % 2 == 0) {
+            ASSERT_TRUE(results.succeeded(i));
+            ASSERT_TRUE(results.get_error(i).empty());
+            ASSERT_EQ(i, numbers[i]);
+            ASSERT_EQ(0.25, rates[i]);
+            ASSERT_TRUE(files[i] == "file" + std::to_string(i));
+            ASSERT_EQ(1, flags[i]);
+            ASSERT_EQ(1, number_given[i]);
+        } else {
+            ASSERT_TRUE(results.succeeded(i));
+            ASSERT_EQ(-1, numbers[i]);
+            ASSERT_EQ(i + 0.5, rates[i]);
+            ASSERT_TRUE(files[i] == "none");
+            ASSERT_EQ(0, flags[i]);
+            ASSERT_EQ(0, number_given[i]);
+        }
+    }
+    ASSERT_EQ(failures, results.get_failure_count());
+    
+    return true;
+}
+
+// Test that the thread count does not change the results
+bool test_batch_thread_counts() {
+    parser p;
+    handle<i64> number = p.add_parameter<i64>("n", "number", "A number", false, "0");
+    
+    batch_input batch = make_batch(3000);
+    batch_result single;
+    batch_result many;
+    p.parse_batch(batch.inputs, single, 1);
+    for (u32 threads : {2u, 3u, 8u, 0u}) {
+        p.parse_batch(batch.inputs, many, threads);
+        ASSERT_EQ(single.size(), many.size());
+        ASSERT_EQ(single.get_failure_count(), many.get_failure_count());
+        for (u64 i = 0; i < single.size(); i++) {
+            ASSERT_EQ(single.column(number)[i], many.column(number)[i]);
+            ASSERT_EQ(single.succeeded(i), many.succeeded(i));
+        }
+    }
+    
+    return true;
+}
+
+// Test small and empty batches and reusing a result
+bool test_batch_small_and_empty() {
+    parser p;
+    handle<i64> number = p.add_parameter<i64>("n", "number", "A number", false, "5");
+    
+    batch_result results;
+    batch_input batch = make_batch(100);
+    p.parse_batch(batch.inputs, results, 8);
+    ASSERT_EQ(100u, results.size());
+    
+    batch_input small;
+    small.add({"tool", "-n", "9"});
+    small.finish();
+    ASSERT_TRUE(p.parse_batch(small.inputs, results, 8));
+    ASSERT_EQ(1u, results.size());
+    ASSERT_EQ(0u, results.get_failure_count());
+    ASSERT_EQ(9, results.column(number)[0]);
+    
+    std::vector<arg_vector> none;
+    ASSERT_TRUE(p.parse_batch(none, results));
+    ASSERT_EQ(0u, results.size());
+    ASSERT_EQ(0u, results.column(number).size());
+    
+    return true;
+}
+
+// Main test runner
+int main() {
+    std::cout << "Running batch tests..." << std::endl;
+    
+    RUN_TEST(test_batch_columns);
+    RUN_TEST(test_batch_thread_counts);
+    RUN_TEST(test_batch_small_and_empty);
+    
+    print_test_summary();
+    
+    return tests_failed > 0 ? 1 : 0;
+}
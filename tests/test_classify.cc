@@ -0,0 +1,70 @@
+#include "test_framework.h"
+#include "argparse/parser.h"
+#include "argparse/token_classify.h"
+#include <string>
+#include <vector>
+
+using namespace argparse;
+
+// Test the kind of single tokens
+bool test_classify_token() {
+    u32 separator = 0;
+    ASSERT_EQ(TOKEN_POSITIONAL, classify_token("file.txt", separator));
+    ASSERT_EQ(TOKEN_POSITIONAL, classify_token("", separator));
+    ASSERT_EQ(TOKEN_POSITIONAL, classify_token("a=b", separator));
+    ASSERT_EQ(TOKEN_SHORT, classify_token("-v", separator));
+    ASSERT_EQ(TOKEN_POSITIONAL, classify_token("-", separator));
+    ASSERT_EQ(TOKEN_SHORT, classify_token("-o=x", separator));
+    ASSERT_EQ(TOKEN_LONG, classify_token("--verbose", separator));
+    ASSERT_EQ(TOKEN_TERMINATOR, classify_token("--", separator));
+    ASSERT_EQ(TOKEN_LONG_VALUE, classify_token("--name=a=b", separator));
+    ASSERT_EQ(6u, separator);
+    ASSERT_EQ(TOKEN_LONG_VALUE, classify_token("--=x", separator));
+    ASSERT_EQ(2u, separator);
+    
+    return true;
+}
+
+// Test that parsing a NUL separated buffer behaves as parsing argv
+bool test_parse_matches_argv() {
+    parser p;
+    p.set_auto_help(false);
+    p.add_parameter("v", "verbose", "Verbose mode", NONE);
+    p.add_parameter("n", "number", "A number", INTEGER, false, "1");
+    
+    std::vector<std::vector<std::string>> lines = {
+        {"tool", "-v", "--number", "5"},
+        {"tool", "--number", "-5"},
+        {"tool", "--"},
+        {"tool", "-"},
+        {"tool", "--number=5"},
+        {"tool", "stray"},
+        {"tool", "--number"},
+    };
+    for (const std::vector<std::string>& args : lines) {
+        std::string buffer;
+        for (const std::string& arg : args) {
+            buffer += arg;
+            buffer += '\0';
+        }
+        parse_result from_strings;
+        parse_result from_buffer;
+        bool parsed = p.parse(args, from_strings);
+        ASSERT_EQ(parsed, p.parse_cmdline(buffer, from_buffer));
+        ASSERT_STREQ(from_strings.get_error(), from_buffer.get_error());
+    }
+    
+    return true;
+}
+
+// Main test runner
+int main() {
+    std::cout << "Running token classification tests..." << std::endl;
+    
+    RUN_TEST(test_classify_token);
+    RUN_TEST(test_parse_matches_argv);
+    
+    print_test_summary();
+    
+    return tests_failed > 0 ? 1 : 0;
+}
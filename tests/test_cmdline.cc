@@ -0,0 +1,156 @@
+#include "allocation_counter.h"
+#include "test_fixtures.h"
+#include <chrono>
+#include <csignal>
+#include <string>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace argparse;
+
+static const char* SCAN_TARGET = "argparse-scan-target";
+
+// Test parsing a NUL separated buffer into a result
+bool test_parse_cmdline() {
+    parser p;
+    test_options h = add_test_options(p);
+    p.freeze();
+    std::string text = join({"/usr/sbin/server", "--number", "8080", "-v", "--file", ""}, '\0');
+    
+    parse_result result;
+    ASSERT_TRUE(p.parse_cmdline(text, result));
+    ASSERT_STREQ("server", result.get_program_name());
+    ASSERT_EQ(8080, result.get(h.number));
+    ASSERT_TRUE(result.get(h.verbose));
+    ASSERT_STREQ("", result.get(h.file));
+    
+    // a buffer whose last argument is not terminated
+    text.pop_back();
+    text += "svc";
+    ASSERT_TRUE(p.parse_cmdline(text, result));
+    ASSERT_STREQ("svc", result.get(h.file));
+    
+    // an empty buffer, as for kernel threads, has no arguments at all
+    ASSERT_TRUE(p.parse_cmdline(std::string_view(), result));
+    ASSERT_EQ(1, result.get(h.number));
+    
+    ASSERT_FALSE(p.parse_cmdline(join({"server", "--number", "eighty"}, '\0'), result));
+    ASSERT_STREQ("error: invalid value eighty for parameter number", result.get_error());
+    
+    return true;
+}
+
+// Test that a reused result parses buffers without allocating
+bool test_parse_cmdline_does_not_allocate() {
+    parser p;
+    test_options h = add_test_options(p);
+    p.freeze();
+    std::string text = join({"/usr/sbin/server", "-n", "443", "--file", "a-path-longer-than-small-strings", "-v"}, '\0');
+    
+    parse_result result;
+    ASSERT_TRUE(p.parse_cmdline(text, result));
+    bool ok = false;
+    ASSERT_NO_ALLOCATIONS(ok = p.parse_cmdline(text, result));
+    ASSERT_TRUE(ok);
+    ASSERT_EQ(443, result.get(h.number));
+    
+    return true;
+}
+
+// Test tokens of a buffer read in any order
+bool test_token_list_buffer() {
+    std::string text = join({"a", "", "bcd", "e"}, '\0');
+    token_list tokens(text, '\0');
+    ASSERT_EQ(4u, tokens.size());
+    ASSERT_STREQ("bcd", tokens[2]);
+    ASSERT_STREQ("", tokens[1]);
+    ASSERT_STREQ("e", tokens[3]);
+    ASSERT_STREQ("a", tokens[0]);
+    
+    token_list lines("x\ny", '\n');
+    ASSERT_EQ(2u, lines.size());
+    ASSERT_STREQ("y", lines[1]);
+    
+    return true;
+}
+
+// Test scanning running processes and parsing their command lines in a batch
+bool test_scan_processes() {
+    std::vector<pid_t> children;
+    for (const char* number : {"7001", "7002"}) {
+        pid_t child = fork();
+        if (child == 0) {
+            const char* argv[] = {SCAN_TARGET, "--number", number, "-f", "worker", nullptr};
+            execv("/proc/self/exe", (char**)argv);
+            _exit(1);
+        }
+        children.push_back(child);
+    }
+    
+    parser p;
+    test_options h = add_test_options(p);
+    p.freeze();
+    process_scan processes;
+    // wait for both children to have replaced their command line
+    bool scanned = false;
+    for (int attempt = 0; attempt < 200; attempt++) {
+        scanned = processes.scan(SCAN_TARGET);
+        if (!scanned || processes.size() == 2) {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    
+    batch_result results;
+    bool parsed = p.parse_batch(processes, results);
+    for (pid_t child : children) {
+        kill(child, SIGKILL);
+        waitpid(child, nullptr, 0);
+    }
+    ASSERT_TRUE(scanned);
+    ASSERT_EQ(2u, processes.size());
+    ASSERT_TRUE(parsed);
+    ASSERT_EQ(2u, results.size());
+    
+    span<const i64> numbers = results.column(h.number);
+    span<const std::string_view> files = results.column(h.file);
+    for (u64 row = 0; row < results.size(); row++) {
+        i32 pid = processes.get_pid(row);
+        ASSERT_TRUE(pid == children[0] || pid == children[1]);
+        ASSERT_EQ(pid == children[0] ? 7001 : 7002, numbers[row]);
+        ASSERT_STREQ("worker", files[row]);
+    }
+    
+    // every process matches an empty program name, this one among them
+    ASSERT_TRUE(processes.scan(""));
+    bool found_self = false;
+    for (u64 row = 0; row < processes.size(); row++) {
+        found_self = found_self || processes.get_pid(row) == getpid();
+    }
+    ASSERT_TRUE(found_self);
+    
+    return true;
+}
+
+// Main test runner
+int main(int argc, char** argv) {
+    // started by test_scan_processes: wait to be scanned
+    if (argc > 0 && std::string(argv[0]) == SCAN_TARGET) {
+        while (true) {
+            pause();
+        }
+    }
+    
+    std::cout << "Running command line buffer tests..." << std::endl;
+    
+    RUN_TEST(test_parse_cmdline);
+    RUN_TEST(test_parse_cmdline_does_not_allocate);
+    RUN_TEST(test_token_list_buffer);
+    RUN_TEST(test_scan_processes);
+    
+    print_test_summary();
+    
+    return tests_failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,259 @@
+#include "test_framework.h"
+#include "argparse/convert.h"
+#include "argparse/parser.h"
+#include <string>
+#include <vector>
+
+using namespace argparse;
+
+// Test plain decimal integers
+bool test_convert_integer_decimal() {
+    i64 value = 0;
+    ASSERT_EQ(CONVERT_OK, convert::to_integer("123", value));
+    ASSERT_EQ(123, value);
+    ASSERT_EQ(CONVERT_OK, convert::to_integer("-456", value));
+    ASSERT_EQ(-456, value);
+    ASSERT_EQ(CONVERT_OK, convert::to_integer("+789", value));
+    ASSERT_EQ(789, value);
+    ASSERT_EQ(CONVERT_OK, convert::to_integer("0", value));
+    ASSERT_EQ(0, value);
+    return true;
+}
+
+// Test that anything but a complete number is rejected
+bool test_convert_integer_invalid() {
+    i64 value = 99;
+    ASSERT_EQ(CONVERT_INVALID, convert::to_integer("12abc", value));
+    ASSERT_EQ(CONVERT_INVALID, convert::to_integer("abc", value));
+    ASSERT_EQ(CONVERT_INVALID, convert::to_integer("", value));
+    ASSERT_EQ(CONVERT_INVALID, convert::to_integer("-", value));
+    ASSERT_EQ(CONVERT_INVALID, convert::to_integer("+", value));
+    ASSERT_EQ(CONVERT_INVALID, convert::to_integer("--5", value));
+    ASSERT_EQ(CONVERT_INVALID, convert::to_integer("+-5", value));
+    ASSERT_EQ(CONVERT_INVALID, convert::to_integer(" 5", value));
+    ASSERT_EQ(CONVERT_INVALID, convert::to_integer("5 ", value));
+    ASSERT_EQ(CONVERT_INVALID, convert::to_integer("1.5", value));
+    // The output is left alone on failure
+    ASSERT_EQ(99, value);
+    return true;
+}
+
+// Test overflow detection for every integer width
+bool test_convert_integer_widths() {
+    i8 v8 = 0;
+    ASSERT_EQ(CONVERT_OK, convert::to_integer("127", v8));
+    ASSERT_EQ(127, v8);
+    ASSERT_EQ(CONVERT_OK, convert::to_integer("-128", v8));
+    ASSERT_EQ(-128, v8);
+    ASSERT_EQ(CONVERT_OUT_OF_RANGE, convert::to_integer("128", v8));
+    ASSERT_EQ(CONVERT_OUT_OF_RANGE, convert::to_integer("-129", v8));
+    
+    u8 u8_value = 0;
+    ASSERT_EQ(CONVERT_OK, convert::to_integer("255", u8_value));
+    ASSERT_EQ(255, u8_value);
+    ASSERT_EQ(CONVERT_OUT_OF_RANGE, convert::to_integer("256", u8_value));
+    ASSERT_EQ(CONVERT_OUT_OF_RANGE, convert::to_integer("-1", u8_value));
+    ASSERT_EQ(CONVERT_OK, convert::to_integer("-0", u8_value));
+    ASSERT_EQ(0, u8_value);
+    
+    i16 v16 = 0;
+    ASSERT_EQ(CONVERT_OK, convert::to_integer("-32768", v16));
+    ASSERT_EQ(-32768, v16);
+    ASSERT_EQ(CONVERT_OUT_OF_RANGE, convert::to_integer("32768", v16));
+    
+    u16 u16_value = 0;
+    ASSERT_EQ(CONVERT_OUT_OF_RANGE, convert::to_integer("65536", u16_value));
+    
+    i32 v32 = 0;
+    ASSERT_EQ(CONVERT_OK, convert::to_integer("2147483647", v32));
+    ASSERT_EQ(2147483647, v32);
+    ASSERT_EQ(CONVERT_OUT_OF_RANGE, convert::to_integer("2147483648", v32));
+    
+    u32 u32_value = 0;
+    ASSERT_EQ(CONVERT_OK, convert::to_integer("4294967295", u32_value));
+    ASSERT_EQ(CONVERT_OUT_OF_RANGE, convert::to_integer("4294967296", u32_value));
+    
+    i64 v64 = 0;
+    ASSERT_EQ(CONVERT_OK, convert::to_integer("-9223372036854775808", v64));
+    ASSERT_TRUE(v64 == std::numeric_limits<i64>::min());
+    ASSERT_EQ(CONVERT_OK, convert::to_integer("9223372036854775807", v64));
+    ASSERT_TRUE(v64 == std::numeric_limits<i64>::max());
+    ASSERT_EQ(CONVERT_OUT_OF_RANGE, convert::to_integer("9223372036854775808", v64));
+    ASSERT_EQ(CONVERT_OUT_OF_RANGE, convert::to_integer("-9223372036854775809", v64));
+    
+    u64 u64_value = 0;
+    ASSERT_EQ(CONVERT_OK, convert::to_integer("18446744073709551615", u64_value));
+    ASSERT_TRUE(u64_value == std::numeric_limits<u64>::max());
+    ASSERT_EQ(CONVERT_OUT_OF_RANGE, convert::to_integer("18446744073709551616", u64_value));
+    ASSERT_EQ(CONVERT_OUT_OF_RANGE, convert::to_integer("99999999999999999999999", u64_value));
+    
+    return true;
+}
+
+// Test other bases
+bool test_convert_integer_bases() {
+    i64 value = 0;
+    ASSERT_EQ(CONVERT_OK, convert::to_integer("ff", value, 16));
+    ASSERT_EQ(255, value);
+    ASSERT_EQ(CONVERT_OK, convert::to_integer("0xFF", value, 16));
+    ASSERT_EQ(255, value);
+    ASSERT_EQ(CONVERT_OK, convert::to_integer("-0x10", value, 16));
+    ASSERT_EQ(-16, value);
+    ASSERT_EQ(CONVERT_OK, convert::to_integer("17", value, 8));
+    ASSERT_EQ(15, value);
+    ASSERT_EQ(CONVERT_INVALID, convert::to_integer("8", value, 8));
+    ASSERT_EQ(CONVERT_INVALID, convert::to_integer("0x", value, 16));
+    ASSERT_EQ(CONVERT_INVALID, convert::to_integer("1", value, 1));
+    
+    // Base 0 detects the base from the prefix
+    ASSERT_EQ(CONVERT_OK, convert::to_integer("0x1f", value, 0));
+    ASSERT_EQ(31, value);
+    ASSERT_EQ(CONVERT_OK, convert::to_integer("010", value, 0));
+    ASSERT_EQ(8, value);
+    ASSERT_EQ(CONVERT_OK, convert::to_integer("10", value, 0));
+    ASSERT_EQ(10, value);
+    ASSERT_EQ(CONVERT_OK, convert::to_integer("0", value, 0));
+    ASSERT_EQ(0, value);
+    
+    return true;
+}
+
+// Test floating point conversion
+bool test_convert_float() {
+    f64 value = 0.0;
+    ASSERT_EQ(CONVERT_OK, convert::to_float("3.14", value));
+    ASSERT_EQ(3.14, value);
+    ASSERT_EQ(CONVERT_OK, convert::to_float("-2.5", value));
+    ASSERT_EQ(-2.5, value);
+    ASSERT_EQ(CONVERT_OK, convert::to_float("+1e3", value));
+    ASSERT_EQ(1000.0, value);
+    ASSERT_EQ(CONVERT_OK, convert::to_float("42", value));
+    ASSERT_EQ(42.0, value);
+    ASSERT_EQ(CONVERT_OK, convert::to_float(".5", value));
+    ASSERT_EQ(0.5, value);
+    
+    value = 7.0;
+    ASSERT_EQ(CONVERT_INVALID, convert::to_float("1.5x", value));
+    ASSERT_EQ(CONVERT_INVALID, convert::to_float("", value));
+    ASSERT_EQ(CONVERT_INVALID, convert::to_float("+", value));
+    ASSERT_EQ(CONVERT_INVALID, convert::to_float("+-1", value));
+    ASSERT_EQ(CONVERT_INVALID, convert::to_float("1,5", value));
+    ASSERT_EQ(CONVERT_OUT_OF_RANGE, convert::to_float("1e999", value));
+    ASSERT_EQ(7.0, value);
+    
+    f32 single = 0.0f;
+    ASSERT_EQ(CONVERT_OK, convert::to_float("0.25", single));
+    ASSERT_EQ(0.25f, single);
+    ASSERT_EQ(CONVERT_OUT_OF_RANGE, convert::to_float("1e100", single));
+    
+    return true;
+}
+
+// Test that a parser reports bad values instead of throwing
+bool test_convert_parser_rejects_bad_values() {
+    parser p;
+    p.set_auto_help(false);
+    p.add_parameter("n", "number", "A number", INTEGER, false, "5");
+    p.add_parameter("r", "rate", "A rate", FLOAT, false, "1.0");
+    
+    std::vector<std::string> args = {"program", "-n", "12abc"};
+    ASSERT_FALSE(p.parse(args));
+    args = {"program", "-r", "fast"};
+    ASSERT_FALSE(p.parse(args));
+    args = {"program", "-n", "99999999999999999999"};
+    ASSERT_FALSE(p.parse(args));
+    
+    i64 number = 0;
+    ASSERT_TRUE(p.get_parameter_value_to("n", &number));
+    ASSERT_EQ(5, number);
+    
+    args = {"program", "-n", "12", "-r", "0.5"};
+    ASSERT_TRUE(p.parse(args));
+    ASSERT_TRUE(p.get_parameter_value_to("n", &number));
+    ASSERT_EQ(12, number);
+    
+    // Empty defaults no longer throw at registration
+    p.add_parameter("c", "count", "A count", INTEGER, false);
+    ASSERT_TRUE(p.get_parameter_value_to("c", &number));
+    ASSERT_EQ(0, number);
+    
+    return true;
+}
+
+// Test lists of integers against converting each field on its own
+bool test_convert_integer_lists() {
+    std::vector<std::string> fields = {"0", "7", "-7", "12345678", "123456789", "-9999999999999999",
+        "1234567890123456", "12345678901234567", "9223372036854775807", "-9223372036854775808",
+        "+42", "0042", "-0"};
+    std::string text;
+    for (const std::string& field : fields) {
+        text += (text.empty() ? "" : ",") + field;
+    }
+    // fields of every length crossing the 16 and 32 byte blocks
+    for (int i = 0; i < 200; i++) {
+        text += "," + std::to_string((i * 7919LL) % 1000003 * (i % 3 == 0 ? -1 : 1) * (i % 17 + 1) * 100003LL);
+        fields.push_back(text.substr(text.rfind(',') + 1));
+    }
+    std::pmr::vector<i64> values;
+    ASSERT_EQ(CONVERT_OK, convert::to_integers(text, ',', values));
+    ASSERT_EQ((i64)fields.size(), (i64)values.size());
+    for (u64 i = 0; i < fields.size(); i++) {
+        i64 expected = 0;
+        ASSERT_EQ(CONVERT_OK, convert::to_integer(fields[i], expected));
+        ASSERT_EQ(expected, values[i]);
+    }
+
+    // values are appended, and left alone on failure
+    ASSERT_EQ(CONVERT_OK, convert::to_integers("", ',', values));
+    ASSERT_EQ(CONVERT_OK, convert::to_integers("5", ',', values));
+    ASSERT_EQ((i64)fields.size() + 1, (i64)values.size());
+    std::string_view field;
+    for (const char* bad : {"1,,2", "1,2,", ",1", "1,x2,3", "1, 2", "9223372036854775808", "1-2", "--1"}) {
+        ASSERT_TRUE(convert::to_integers(bad, ',', values, &field) != CONVERT_OK);
+        ASSERT_EQ((i64)fields.size() + 1, (i64)values.size());
+    }
+    ASSERT_EQ(CONVERT_INVALID, convert::to_integers("1,2,12a,4", ',', values, &field));
+    ASSERT_TRUE(field == "12a");
+    ASSERT_EQ(CONVERT_OUT_OF_RANGE, convert::to_integers("1,99999999999999999999", ',', values, &field));
+    ASSERT_TRUE(field == "99999999999999999999");
+
+    return true;
+}
+
+// Test lists of floating point values
+bool test_convert_float_lists() {
+    std::pmr::vector<f64> values;
+    ASSERT_EQ(CONVERT_OK, convert::to_floats("0.5,-2,1e3,+4.25,.5", ',', values));
+    ASSERT_EQ(5, (i64)values.size());
+    ASSERT_EQ(0.5, values[0]);
+    ASSERT_EQ(-2.0, values[1]);
+    ASSERT_EQ(1000.0, values[2]);
+    ASSERT_EQ(4.25, values[3]);
+    ASSERT_EQ(0.5, values[4]);
+    ASSERT_EQ(CONVERT_OK, convert::to_floats("1;2", ';', values));
+    ASSERT_EQ(7, (i64)values.size());
+    std::string_view field;
+    ASSERT_EQ(CONVERT_INVALID, convert::to_floats("1.5,abc", ',', values, &field));
+    ASSERT_TRUE(field == "abc");
+    ASSERT_EQ(7, (i64)values.size());
+
+    return true;
+}
+
+// Main test runner
+int main() {
+    std::cout << "Running conversion tests..." << std::endl;
+    
+    RUN_TEST(test_convert_integer_decimal);
+    RUN_TEST(test_convert_integer_invalid);
+    RUN_TEST(test_convert_integer_widths);
+    RUN_TEST(test_convert_integer_bases);
+    RUN_TEST(test_convert_float);
+    RUN_TEST(test_convert_parser_rejects_bad_values);
+    RUN_TEST(test_convert_integer_lists);
+    RUN_TEST(test_convert_float_lists);
+    
+    print_test_summary();
+    
+    return tests_failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,62 @@
+#include "test_fixtures.h"
+
+using namespace argparse;
+
+test_options add_test_options(parser& p) {
+    p.set_auto_help(false);
+    test_options o;
+    o.verbose = p.add_parameter<bool>("v", "verbose", "Print every step while processing the input");
+    o.all = p.add_parameter<bool>("a", "all", "Process all files, including hidden ones");
+    o.number = p.add_parameter<i64>("n", "number", "Number of iterations to run before stopping", false, "1");
+    o.rate = p.add_parameter<f64>("r", "rate", "Sampling rate used for the measurements", false, "0.5");
+    o.file = p.add_parameter<std::string>("f", "file", "Path of the input file to be processed", false, "input.txt");
+    o.output = p.add_parameter<std::string>("o", "output", "Path of the output file to be written", false, "out.txt");
+    o.level = p.add_parameter<i64>("lvl", "", "Log level, with a multi-character short name", false, "0");
+    o.long_only = p.add_parameter<bool>("", "a-rather-long-option-name", "An option without a short name at all");
+    return o;
+}
+
+std::vector<std::string> make_tokens(u64 count) {
+    std::vector<std::string> tokens;
+    tokens.reserve(count);
+    tokens.push_back("/usr/bin/tool");
+    while (tokens.size() + 2 <= count) {
+        u64 n = tokens.size();
+        if (n % 8 == 1) {
+            tokens.push_back("--number");
+            tokens.push_back(std::to_string(n));
+        } else {
+            tokens.push_back("-f");
+            tokens.push_back("/data/input/part-" + std::to_string(n) + ".csv");
+        }
+    }
+    if (tokens.size() < count) {
+        tokens.push_back("-v");
+    }
+    return tokens;
+}
+
+std::vector<const char*> pointers(const std::vector<std::string>& tokens) {
+    std::vector<const char*> argv;
+    for (const std::string& token : tokens) {
+        argv.push_back(token.c_str());
+    }
+    return argv;
+}
+
+std::string join(const std::vector<std::string>& tokens, char delimiter) {
+    std::string text;
+    for (const std::string& token : tokens) {
+        text += token;
+        text += delimiter;
+    }
+    return text;
+}
+
+std::string parse_error(const parser& p, const std::vector<std::string>& args) {
+    parse_result result;
+    if (p.parse(args, result)) {
+        return "";
+    }
+    return std::string(result.get_error());
+}
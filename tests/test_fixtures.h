@@ -0,0 +1,38 @@
+#ifndef TEST_FIXTURES_H
+#define TEST_FIXTURES_H
+
+#include "argparse/parser.h"
+#include <string>
+#include <vector>
+
+// Builders shared by the tests that parse a common set of options
+
+// Handles of the options add_test_options registers
+struct test_options {
+    argparse::handle<bool> verbose;          // -v, --verbose
+    argparse::handle<bool> all;              // -a, --all
+    argparse::handle<argparse::i64> number;  // -n, --number, default 1
+    argparse::handle<argparse::f64> rate;    // -r, --rate, default 0.5
+    argparse::handle<std::string> file;      // -f, --file, default input.txt
+    argparse::handle<std::string> output;    // -o, --output, default out.txt
+    argparse::handle<argparse::i64> level;   // -lvl, a multi-character short name, default 0
+    argparse::handle<bool> long_only;        // --a-rather-long-option-name, no short name
+};
+
+// Add the common options to p and turn auto-help off
+test_options add_test_options(argparse::parser& p);
+
+// Command line of count tokens, mostly input paths as data tools receive them
+std::vector<std::string> make_tokens(argparse::u64 count);
+
+// argv of tokens, valid while tokens is
+std::vector<const char*> pointers(const std::vector<std::string>& tokens);
+
+// Tokens each followed by delimiter, as in /proc/<pid>/cmdline or the output
+// of find -print0
+std::string join(const std::vector<std::string>& tokens, char delimiter);
+
+// Error of parsing args into a result, empty if they parse
+std::string parse_error(const argparse::parser& p, const std::vector<std::string>& args);
+
+#endif
@@ -0,0 +1,168 @@
+#include "allocation_counter.h"
+#include "test_fixtures.h"
+#include "argparse/parser.h"
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace argparse;
+
+// Test -fname and -fno-name toggles with their defaults
+bool test_feature_flags() {
+    parser p;
+    p.set_auto_help(false);
+    handle<bool> verbose = p.add_parameter<bool>("v", "verbose", "Verbose mode");
+    handle<flag_set> features = p.add_flag_family("feature", "-f", "-fno-", "Compiler features");
+    i32 exceptions = p.add_flag(features, "exceptions", true);
+    i32 rtti = p.add_flag(features, "rtti", true);
+    i32 pic = p.add_flag(features, "PIC");
+    i32 lto = p.add_flag(features, "lto");
+
+    parse_result result;
+    ASSERT_TRUE(p.parse(std::vector<std::string>{"cc"}, result));
+    flag_set flags = result.get(features);
+    ASSERT_EQ(4, (i64)flags.size());
+    ASSERT_TRUE(flags.test(exceptions));
+    ASSERT_TRUE(flags.test(rtti));
+    ASSERT_FALSE(flags.test(pic));
+    ASSERT_FALSE(result.is_set(features));
+
+    ASSERT_TRUE(p.parse(std::vector<std::string>{"cc", "-fno-exceptions", "-v", "-fPIC", "-flto", "-fno-lto"}, result));
+    flags = result.get(features);
+    ASSERT_FALSE(flags.test(exceptions));
+    ASSERT_TRUE(flags.test(rtti));
+    ASSERT_TRUE(flags.test(pic));
+    // the last token for a flag wins
+    ASSERT_FALSE(flags.test(lto));
+    ASSERT_EQ(2, (i64)flags.count());
+    ASSERT_TRUE(result.get(verbose));
+    ASSERT_TRUE(result.is_set(features));
+
+    ASSERT_FALSE(p.parse(std::vector<std::string>{"cc", "-fbogus"}, result));
+    ASSERT_STREQ("error: unknown parameter fbogus", result.get_error());
+    ASSERT_FALSE(p.parse(std::vector<std::string>{"cc", "-fno-"}, result));
+    ASSERT_STREQ("error: unknown parameter fno-", result.get_error());
+
+    return true;
+}
+
+// Test --enable-name and --disable-name next to ordinary options
+bool test_enable_disable() {
+    parser p;
+    p.set_auto_help(false);
+    handle<std::string> prefix = p.add_parameter<std::string>("", "prefix", "Install prefix", false, "/usr");
+    handle<bool> enable_all = p.add_parameter<bool>("", "enable-all", "Enable everything");
+    handle<flag_set> options = p.add_flag_family("option", "--enable-", "--disable-", "Build options");
+    i32 docs = p.add_flag(options, "docs", true);
+    i32 shared = p.add_flag(options, "shared");
+    // a flag named like a disabled one is still reachable
+    i32 no_color = p.add_flag(options, "no-color");
+
+    std::vector<std::string> args = {"configure", "--disable-docs", "--prefix", "/opt", "--enable-shared", "--enable-all", "--enable-no-color"};
+    parse_result result;
+    ASSERT_TRUE(p.parse(args, result));
+    flag_set flags = result.get(options);
+    ASSERT_FALSE(flags.test(docs));
+    ASSERT_TRUE(flags.test(shared));
+    ASSERT_TRUE(flags.test(no_color));
+    // an option of the same name is found before the family
+    ASSERT_TRUE(result.get(enable_all));
+    ASSERT_TRUE(result.get(prefix) == "/opt");
+
+    ASSERT_FALSE(p.parse(std::vector<std::string>{"configure", "--enable-docs=yes"}, result));
+    ASSERT_STREQ("error: unknown parameter enable-docs", result.get_error());
+    ASSERT_FALSE(p.parse(std::vector<std::string>{"configure", "--disable-bogus"}, result));
+    ASSERT_STREQ("error: unknown parameter disable-bogus", result.get_error());
+
+    return true;
+}
+
+// Test registration errors, lookups, the stateful parser, streams and help
+bool test_family_registration() {
+    parser p;
+    p.set_auto_help(false);
+    handle<flag_set> features = p.add_flag_family("feature", "-f", "-fno-", "Compiler features");
+    ASSERT_FALSE(p.add_flag_family("bad", "f", "-fno-", "No dash").is_valid());
+    ASSERT_EQ(0, p.add_flag(features, "exceptions", true));
+    ASSERT_EQ(1, p.add_flag(features, "PIC"));
+    ASSERT_EQ(-1, p.add_flag(features, "PIC"));
+    ASSERT_EQ(-1, p.add_flag(features, ""));
+    ASSERT_EQ(-1, p.add_flag(handle<flag_set>(), "x"));
+    ASSERT_EQ(1, p.find_flag(features, "PIC"));
+    ASSERT_EQ(-1, p.find_flag(features, "pic"));
+
+    // the defaults before any parse
+    ASSERT_TRUE(p.get(features).test(0));
+    ASSERT_FALSE(p.get(features).test(1));
+
+    ASSERT_TRUE(p.parse(std::vector<std::string>{"cc", "-fPIC", "-fno-exceptions"}));
+    ASSERT_TRUE(p.get(features).test(1));
+    ASSERT_FALSE(p.get(features).test(0));
+    flag_set copy;
+    ASSERT_TRUE(p.get_parameter_value_to("feature", &copy));
+    ASSERT_TRUE(copy.test(1));
+
+    std::istringstream in(std::string("-fno-PIC\0-fexceptions\0", 22));
+    token_stream tokens(in, '\0', 4);
+    ASSERT_TRUE(p.parse_stream(tokens));
+    ASSERT_FALSE(p.get(features).test(1));
+    ASSERT_TRUE(p.get(features).test(0));
+
+    std::string help = p.get_help_message();
+    ASSERT_TRUE(help.find("\n-f<feature>, -fno-<feature>\tCompiler features") != std::string::npos);
+    ASSERT_TRUE(help.find("--feature") == std::string::npos);
+
+    return true;
+}
+
+// Test two families of 2000 toggles parsed without allocating
+bool test_many_flags_without_allocation() {
+    parser p;
+    p.set_auto_help(false);
+    handle<flag_set> features = p.add_flag_family("feature", "-f", "-fno-", "Compiler features");
+    handle<flag_set> options = p.add_flag_family("option", "--enable-", "--disable-", "Build options");
+    std::vector<std::string> names;
+    for (int i = 0; i < 2000; i++) {
+        names.push_back("feature-" + std::to_string(i));
+        ASSERT_EQ(i, p.add_flag(features, names.back(), i % 2 == 0));
+        ASSERT_EQ(i, p.add_flag(options, names.back()));
+    }
+    p.freeze();
+
+    std::vector<std::string> args = {"cc"};
+    for (int i = 0; i < 2000; i += 3) {
+        args.push_back((i % 2 == 0 ? "-fno-" : "-f") + names[i]);
+        args.push_back("--enable-" + names[i]);
+    }
+    std::vector<const char*> argv = pointers(args);
+    parse_result result;
+    ASSERT_TRUE(p.parse((int)argv.size(), argv.data(), result));
+    ASSERT_NO_ALLOCATIONS(p.parse((int)argv.size(), argv.data(), result));
+
+    flag_set flags = result.get(features);
+    ASSERT_EQ(2000, (i64)flags.size());
+    ASSERT_EQ(32, (i64)flags.words().size());
+    for (int i = 0; i < 2000; i++) {
+        // every third flag is flipped from its default
+        bool expected = (i % 2 == 0) != (i % 3 == 0);
+        ASSERT_EQ(expected, flags.test(i));
+        ASSERT_EQ(i % 3 == 0, result.get(options).test(i));
+    }
+    ASSERT_EQ(1999, p.find_flag(options, "feature-1999"));
+
+    return true;
+}
+
+// Main test runner
+int main() {
+    std::cout << "Running flag family tests..." << std::endl;
+
+    RUN_TEST(test_feature_flags);
+    RUN_TEST(test_enable_disable);
+    RUN_TEST(test_family_registration);
+    RUN_TEST(test_many_flags_without_allocation);
+
+    print_test_summary();
+
+    return tests_failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,198 @@
+#include "allocation_counter.h"
+#include "test_fixtures.h"
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace argparse;
+
+// Test --name=value, which splits the token in place
+bool test_long_with_value() {
+    parser p;
+    test_options o = add_test_options(p);
+    std::vector<std::string> args = {"prog", "--number=12", "--output=a=b.txt", "--rate=-2.5"};
+    parse_result result;
+    ASSERT_TRUE(p.parse(args, result));
+    ASSERT_EQ(12, result.get(o.number));
+    ASSERT_TRUE(result.get(o.output) == "a=b.txt");
+    ASSERT_EQ(-2.5, result.get(o.rate));
+    // the value is a view into the token after the first '='
+    ASSERT_TRUE(result.get(o.output).data() == args[2].data() + 9);
+
+    ASSERT_TRUE(p.parse(std::vector<std::string>{"prog", "--output="}, result));
+    ASSERT_TRUE(result.get(o.output).empty());
+    ASSERT_TRUE(result.is_set(o.output));
+
+    ASSERT_STREQ("error: parameter verbose does not take a value", parse_error(p, {"prog", "--verbose=1"}));
+    ASSERT_STREQ("error: unknown parameter colour", parse_error(p, {"prog", "--colour=red"}));
+    ASSERT_STREQ("error: invalid value x for parameter number", parse_error(p, {"prog", "--number=x"}));
+    ASSERT_STREQ("error: invalid value  for parameter number", parse_error(p, {"prog", "--number="}));
+
+    return true;
+}
+
+// Test clusters of short options and values attached to them
+bool test_short_clusters() {
+    parser p;
+    test_options o = add_test_options(p);
+    parse_result result;
+    ASSERT_TRUE(p.parse(std::vector<std::string>{"prog", "-va", "-ofile.txt", "-n42"}, result));
+    ASSERT_TRUE(result.get(o.verbose));
+    ASSERT_TRUE(result.get(o.all));
+    ASSERT_TRUE(result.get(o.output) == "file.txt");
+    ASSERT_EQ(42, result.get(o.number));
+
+    // flags then an option taking the rest, or the next token
+    ASSERT_TRUE(p.parse(std::vector<std::string>{"prog", "-avn7", "-vo", "next.txt"}, result));
+    ASSERT_TRUE(result.get(o.all));
+    ASSERT_EQ(7, result.get(o.number));
+    ASSERT_TRUE(result.get(o.output) == "next.txt");
+
+    // a multi-character short name is matched before splitting
+    ASSERT_TRUE(p.parse(std::vector<std::string>{"prog", "-lvl", "3"}, result));
+    ASSERT_EQ(3, result.get(o.level));
+    ASSERT_FALSE(result.get(o.verbose));
+
+    ASSERT_STREQ("error: unknown parameter xyz", parse_error(p, {"prog", "-xyz"}));
+    ASSERT_STREQ("error: unknown parameter x", parse_error(p, {"prog", "-vax"}));
+    ASSERT_STREQ("error: unexpected argument -", parse_error(p, {"prog", "-"}));
+    ASSERT_STREQ("error: parameter o requires a value", parse_error(p, {"prog", "-vo"}));
+    ASSERT_STREQ("error: invalid value 4x for parameter n", parse_error(p, {"prog", "-vn4x"}));
+
+    return true;
+}
+
+// Test negative numbers as the values of numeric options
+bool test_negative_values() {
+    parser p;
+    test_options o = add_test_options(p);
+    parse_result result;
+    ASSERT_TRUE(p.parse(std::vector<std::string>{"prog", "-n", "-5", "--rate", "-.25", "-lvl", "-3", "-n-6"}, result));
+    ASSERT_EQ(-6, result.get(o.number));
+    ASSERT_EQ(-0.25, result.get(o.rate));
+    ASSERT_EQ(-3, result.get(o.level));
+
+    ASSERT_TRUE(p.parse(std::vector<std::string>{"prog", "--number", "-5"}, result));
+    ASSERT_EQ(-5, result.get(o.number));
+
+    // a text option does not take a dash token, nor does any option take an option
+    ASSERT_STREQ("error: parameter o requires a value", parse_error(p, {"prog", "-o", "-5"}));
+    ASSERT_STREQ("error: parameter n requires a value", parse_error(p, {"prog", "-n", "-v"}));
+    ASSERT_STREQ("error: parameter n requires a value", parse_error(p, {"prog", "-n", "--rate"}));
+    ASSERT_STREQ("error: invalid value - for parameter n", parse_error(p, {"prog", "-n", "-"}));
+
+    // a short option named by a digit is an option, not a number
+    parser digits;
+    digits.set_auto_help(false);
+    handle<i64> count = digits.add_parameter<i64>("c", "count", "A count", false, "0");
+    digits.add_parameter<bool>("1", "one", "Single column");
+    ASSERT_TRUE(digits.parse(std::vector<std::string>{"prog", "-c", "-2"}, result));
+    ASSERT_EQ(-2, result.get(count));
+    ASSERT_STREQ("error: parameter c requires a value", parse_error(digits, {"prog", "-c", "-1"}));
+
+    return true;
+}
+
+// Test a lone "-", standard input by convention, as a value and an argument
+bool test_lone_dash() {
+    parser p;
+    test_options o = add_test_options(p);
+    handle<std::string> input = p.add_positional<std::string>("input", "Input file");
+    parse_result result;
+    ASSERT_TRUE(p.parse(std::vector<std::string>{"prog", "-o", "-", "-"}, result));
+    ASSERT_STREQ("-", result.get(o.output));
+    ASSERT_STREQ("-", result.get(input));
+
+    ASSERT_TRUE(p.parse(std::vector<std::string>{"prog", "-v", "-", "--file=-"}, result));
+    ASSERT_TRUE(result.get(o.verbose));
+    ASSERT_STREQ("-", result.get(input));
+    ASSERT_STREQ("-", result.get(o.file));
+
+    return true;
+}
+
+// Test "--", after which every token is an argument
+bool test_terminator() {
+    parser p;
+    test_options o = add_test_options(p);
+    parse_result result;
+    ASSERT_TRUE(p.parse(std::vector<std::string>{"prog", "-v", "--"}, result));
+    ASSERT_TRUE(result.get(o.verbose));
+    ASSERT_STREQ("error: unexpected argument -a", parse_error(p, {"prog", "--", "-a"}));
+    ASSERT_STREQ("error: parameter o requires a value", parse_error(p, {"prog", "-o", "--"}));
+
+    // a stream passes the tokens after "--" to the positional callback
+    std::istringstream in("-v\n--\n-a\n--number=3\n");
+    std::vector<std::string> positionals;
+    ASSERT_TRUE(p.parse_stream(in, '\n', [&](std::string_view token) {
+        positionals.push_back(std::string(token));
+    }));
+    ASSERT_TRUE(p.get(o.verbose));
+    ASSERT_FALSE(p.get(o.all));
+    ASSERT_EQ(1, p.get(o.number));
+    ASSERT_EQ(2, (i64)positionals.size());
+    ASSERT_STREQ("-a", positionals[0]);
+    ASSERT_STREQ("--number=3", positionals[1]);
+
+    return true;
+}
+
+// Test the same forms in a cmdline buffer and in a stream
+bool test_buffer_and_stream_forms() {
+    parser p;
+    test_options o = add_test_options(p);
+    std::string cmdline("prog\0-vn-4\0--output=x.txt\0-r\0-1e3\0", 34);
+    parse_result result;
+    ASSERT_TRUE(p.parse_cmdline(cmdline, result));
+    ASSERT_TRUE(result.get(o.verbose));
+    ASSERT_EQ(-4, result.get(o.number));
+    ASSERT_TRUE(result.get(o.output) == "x.txt");
+    ASSERT_EQ(-1000.0, result.get(o.rate));
+
+    // tiny chunks split the clusters and values across reads
+    std::istringstream in(std::string("--output=y.txt\0-ao\0z.txt\0-n\0-8\0", 31));
+    token_stream tokens(in, '\0', 4);
+    ASSERT_TRUE(p.parse_stream(tokens));
+    ASSERT_TRUE(p.get(o.all));
+    ASSERT_STREQ("z.txt", p.get(o.output));
+    ASSERT_EQ(-8, p.get(o.number));
+
+    std::istringstream flag(std::string("--all=yes\0", 10));
+    ASSERT_FALSE(p.parse_stream(flag));
+
+    return true;
+}
+
+// Test that splitting tokens in place does not allocate
+bool test_forms_without_allocation() {
+    parser p;
+    test_options o = add_test_options(p);
+    p.freeze();
+    const char* argv[] = {"prog", "--number=9", "-vaofile.txt", "-r", "-0.5", "-lvl", "-2", "--"};
+    parse_result result;
+    ASSERT_TRUE(p.parse(8, argv, result));
+    ASSERT_NO_ALLOCATIONS(p.parse(8, argv, result));
+    ASSERT_EQ(9, result.get(o.number));
+    ASSERT_TRUE(result.get(o.output) == "file.txt");
+    ASSERT_EQ(-0.5, result.get(o.rate));
+    ASSERT_EQ(-2, result.get(o.level));
+
+    return true;
+}
+
+// Main test runner
+int main() {
+    std::cout << "Running GNU form tests..." << std::endl;
+
+    RUN_TEST(test_long_with_value);
+    RUN_TEST(test_short_clusters);
+    RUN_TEST(test_negative_values);
+    RUN_TEST(test_lone_dash);
+    RUN_TEST(test_terminator);
+    RUN_TEST(test_buffer_and_stream_forms);
+    RUN_TEST(test_forms_without_allocation);
+
+    print_test_summary();
+
+    return tests_failed > 0 ? 1 : 0;
+}
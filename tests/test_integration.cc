@@ -8,6 +8,7 @@ using namespace argparse;
 // Test realistic command line parsing scenario
 bool test_integration_complex_parsing() {
     parser p;
+    p.set_auto_help(false);
     
     // Add various parameter types
     p.add_parameter("h", "help", "Show help message", NONE, false);
@@ -68,6 +69,7 @@ bool test_integration_complex_parsing() {
 // Test mixed short and long parameter usage
 bool test_integration_mixed_parameters() {
     parser p;
+    p.set_auto_help(false);
     p.add_parameter("f", "file", "Input file", STRING, false, "default.txt");
     p.add_parameter("n", "number", "A number", INTEGER, false, "0");
     p.add_parameter("v", "verbose", "Verbose mode", NONE, false);
@@ -101,6 +103,7 @@ bool test_integration_mixed_parameters() {
 // Test default values
 bool test_integration_default_values() {
     parser p;
+    p.set_auto_help(false);
     p.add_parameter("f", "file", "Input file", STRING, false, "default_file.txt");
     p.add_parameter("n", "number", "A number", INTEGER, false, "42");
     p.add_parameter("r", "rate", "A rate", FLOAT, false, "3.14");
@@ -135,6 +138,7 @@ bool test_integration_default_values() {
 // Test help message formatting
 bool test_integration_help_message_format() {
     parser p;
+    p.set_auto_help(false);
     p.add_parameter("h", "help", "Show this help message", NONE, false);
     p.add_parameter("v", "verbose", "Enable verbose output", NONE, false);
     p.add_parameter("f", "file", "Specify input file", STRING, false, "input.txt");
@@ -164,6 +168,7 @@ bool test_integration_help_message_format() {
 // Test error scenarios in integration
 bool test_integration_error_scenarios() {
     parser p;
+    p.set_auto_help(false);
     p.add_parameter("f", "file", "Input file", STRING, false, "");
     p.add_parameter("n", "number", "A number", INTEGER, false, "0");
     
@@ -185,6 +190,7 @@ bool test_integration_error_scenarios() {
 // Test program name extraction from path
 bool test_integration_program_name_extraction() {
     parser p;
+    p.set_auto_help(false);
     p.add_parameter("h", "help", "Show help", NONE, false);
     
     // Test with full path
@@ -211,6 +217,7 @@ bool test_integration_program_name_extraction() {
 // Test edge cases
 bool test_integration_edge_cases() {
     parser p;
+    p.set_auto_help(false);
     p.add_parameter("f", "file", "Input file", STRING, false, "");
     
     // Test empty program name handling (shouldn't crash)
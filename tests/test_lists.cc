@@ -0,0 +1,206 @@
+#include "allocation_counter.h"
+#include "argparse/parser.h"
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace argparse;
+
+// Test repeated string options, kept as views into argv
+bool test_repeated_strings() {
+    parser p;
+    p.set_auto_help(false);
+    handle<std::vector<std::string_view>> includes = p.add_parameter<std::vector<std::string_view>>("I", "include", "Include directory");
+    handle<bool> verbose = p.add_parameter<bool>("v", "verbose", "Verbose mode");
+
+    const char* argv[] = {"cc", "-I", "src", "-v", "-Iinclude", "--include=a,b", "--include", "/usr/lib"};
+    parse_result result;
+    ASSERT_TRUE(p.parse(8, argv, result));
+    ASSERT_TRUE(result.get(verbose));
+    span<const std::string_view> dirs = result.get(includes);
+    ASSERT_EQ(4, (i64)dirs.size());
+    ASSERT_TRUE(dirs[0] == "src");
+    ASSERT_TRUE(dirs[1] == "include");
+    // text is never split at commas
+    ASSERT_TRUE(dirs[2] == "a,b");
+    ASSERT_TRUE(dirs[3].data() == argv[7]);
+    ASSERT_TRUE(result.is_set(includes));
+
+    ASSERT_TRUE(p.parse(1, argv, result));
+    ASSERT_TRUE(result.get(includes).empty());
+    ASSERT_FALSE(result.is_set(includes));
+
+    return true;
+}
+
+// Test comma separated numbers, repeats and negative values
+bool test_numeric_lists() {
+    parser p;
+    p.set_auto_help(false);
+    handle<std::vector<i64>> ids = p.add_parameter<std::vector<i64>>("i", "ids", "Record ids");
+    handle<std::vector<f64>> weights = p.add_parameter<std::vector<f64>>("w", "weights", "Weights", false, "1,1");
+
+    parse_result result;
+    ASSERT_TRUE(p.parse(std::vector<std::string>{"bench"}, result));
+    ASSERT_TRUE(result.get(ids).empty());
+    ASSERT_EQ(2, (i64)result.get(weights).size());
+    ASSERT_EQ(1.0, result.get(weights)[1]);
+
+    ASSERT_TRUE(p.parse(std::vector<std::string>{"bench", "--ids", "1,2,3", "-w", "-0.5,.25", "-i", "-4", "--ids=5,-6"}, result));
+    span<const i64> id_values = result.get(ids);
+    ASSERT_EQ(6, (i64)id_values.size());
+    ASSERT_EQ(1, id_values[0]);
+    ASSERT_EQ(-4, id_values[3]);
+    ASSERT_EQ(-6, id_values[5]);
+    // given values replace the default
+    span<const f64> weight_values = result.get(weights);
+    ASSERT_EQ(2, (i64)weight_values.size());
+    ASSERT_EQ(-0.5, weight_values[0]);
+    ASSERT_EQ(0.25, weight_values[1]);
+
+    ASSERT_FALSE(p.parse(std::vector<std::string>{"bench", "--ids", "1,x,3"}, result));
+    ASSERT_STREQ("error: invalid value 1,x,3 for parameter ids", result.get_error());
+    ASSERT_FALSE(p.parse(std::vector<std::string>{"bench", "--ids", "1,,3"}, result));
+    ASSERT_FALSE(p.parse(std::vector<std::string>{"bench", "--ids"}, result));
+    ASSERT_STREQ("error: parameter ids requires a value", result.get_error());
+
+    return true;
+}
+
+// Test that interleaved lists and positionals each stay contiguous
+bool test_interleaved_lists() {
+    parser p;
+    p.set_auto_help(false);
+    handle<std::vector<std::string_view>> includes = p.add_parameter<std::vector<std::string_view>>("I", "", "Include directory");
+    handle<std::vector<std::string_view>> libraries = p.add_parameter<std::vector<std::string_view>>("l", "", "Library");
+    handle<std::vector<i64>> ids = p.add_parameter<std::vector<i64>>("", "ids", "Record ids");
+    handle<std::vector<std::string_view>> files = p.add_variadic("files", "Sources");
+
+    const char* argv[] = {"cc", "-l", "m", "a.c", "-I", "x", "--ids", "1,2", "-l", "z", "b.c", "-I", "y", "--ids", "3", "-l", "pthread"};
+    parse_result result;
+    ASSERT_TRUE(p.parse(17, argv, result));
+    span<const std::string_view> libs = result.get(libraries);
+    ASSERT_EQ(3, (i64)libs.size());
+    ASSERT_TRUE(libs[0] == "m");
+    ASSERT_TRUE(libs[1] == "z");
+    ASSERT_TRUE(libs[2] == "pthread");
+    span<const std::string_view> dirs = result.get(includes);
+    ASSERT_EQ(2, (i64)dirs.size());
+    ASSERT_TRUE(dirs[0] == "x");
+    ASSERT_TRUE(dirs[1] == "y");
+    span<const std::string_view> sources = result.get(files);
+    ASSERT_EQ(2, (i64)sources.size());
+    ASSERT_TRUE(sources[0] == "a.c");
+    ASSERT_TRUE(sources[1] == "b.c");
+    ASSERT_EQ(3, (i64)result.get(ids).size());
+    ASSERT_EQ(3, result.get(ids)[2]);
+
+    return true;
+}
+
+// Test the stateful parser, bound vectors, lookups and streams
+bool test_stateful_lists() {
+    parser p;
+    p.set_auto_help(false);
+    std::vector<i64> ids;
+    p.add_parameter("i", "ids", "Record ids", ids);
+    handle<std::vector<f64>> weights = p.add_parameter<std::vector<f64>>("w", "weights", "Weights");
+    handle<std::vector<std::string_view>> tags = p.add_parameter<std::vector<std::string_view>>("t", "tag", "Tags");
+
+    std::vector<std::string> args = {"bench", "-i", "4,5", "-w", "0.5", "-i", "6"};
+    ASSERT_TRUE(p.parse(args));
+    ASSERT_TRUE(ids == std::vector<i64>({4, 5, 6}));
+    ASSERT_EQ(1, (i64)p.get(weights).size());
+    std::vector<f64> weight_values;
+    ASSERT_TRUE(p.get_parameter_value_to("weights", &weight_values));
+    ASSERT_EQ(0.5, weight_values[0]);
+
+    // streamed values are copied, as the stream's buffer is reused
+    std::istringstream in(std::string("-t\0first\0--ids=7,8\0--tag=second\0", 32));
+    token_stream tokens(in, '\0', 4);
+    ASSERT_TRUE(p.parse_stream(tokens));
+    ASSERT_TRUE(ids == std::vector<i64>({7, 8}));
+    ASSERT_EQ(2, (i64)p.get(tags).size());
+    ASSERT_TRUE(p.get(tags)[0] == "first");
+    ASSERT_TRUE(p.get(tags)[1] == "second");
+    ASSERT_TRUE(p.get(weights).empty());
+
+    return true;
+}
+
+// Test that the stateful parser's text lists outlive a temporary vector or argv
+bool test_stateful_lists_outlive_tokens() {
+    parser p;
+    p.set_auto_help(false);
+    handle<std::vector<std::string_view>> includes = p.add_parameter<std::vector<std::string_view>>("I", "include", "Include directory");
+    handle<std::vector<std::string_view>> files = p.add_variadic("files", "Input files");
+
+    ASSERT_TRUE(p.parse(std::vector<std::string>{"prog", "-I", "dir", "--include=/usr/include/a-long-enough-path", "main.c"}));
+    ASSERT_EQ(2, (i64)p.get(includes).size());
+    ASSERT_STREQ("dir", p.get(includes)[0]);
+    ASSERT_STREQ("/usr/include/a-long-enough-path", p.get(includes)[1]);
+    ASSERT_STREQ("main.c", p.get(files)[0]);
+
+    std::vector<std::string>* tokens = new std::vector<std::string>{"prog", "-Isrc", "-I", "include"};
+    std::vector<char*> argv;
+    for (std::string& token : *tokens) {
+        argv.push_back(&token[0]);
+    }
+    ASSERT_TRUE(p.parse((int)argv.size(), argv.data()));
+    delete tokens;
+    ASSERT_EQ(2, (i64)p.get(includes).size());
+    ASSERT_STREQ("src", p.get(includes)[0]);
+    ASSERT_STREQ("include", p.get(includes)[1]);
+    ASSERT_TRUE(p.get(files).empty());
+
+    // a parse into a result still keeps views into the tokens
+    std::vector<std::string> args = {"prog", "-I", "dir"};
+    parse_result result;
+    ASSERT_TRUE(p.parse(args, result));
+    ASSERT_TRUE(result.get(includes)[0].data() == args[2].data());
+
+    return true;
+}
+
+// Test that thousands of ids in one argument parse without allocating
+bool test_long_list_without_allocation() {
+    parser p;
+    p.set_auto_help(false);
+    handle<std::vector<i64>> ids = p.add_parameter<std::vector<i64>>("", "ids", "Record ids");
+    handle<std::vector<f64>> weights = p.add_parameter<std::vector<f64>>("", "weights", "Weights");
+    p.freeze();
+
+    std::string id_text;
+    std::string weight_text;
+    for (int i = 0; i < 10000; i++) {
+        id_text += (i > 0 ? "," : "") + std::to_string(i * 104729LL);
+        weight_text += (i > 0 ? "," : "") + std::to_string(i) + ".5";
+    }
+    const char* argv[] = {"bench", "--ids", id_text.c_str(), "--weights", weight_text.c_str(), "--ids=-1"};
+    parse_result result;
+    ASSERT_TRUE(p.parse(6, argv, result));
+    ASSERT_NO_ALLOCATIONS(p.parse(6, argv, result));
+    span<const i64> id_values = result.get(ids);
+    ASSERT_EQ(10001, (i64)id_values.size());
+    ASSERT_EQ(9999 * 104729LL, id_values[9999]);
+    ASSERT_EQ(-1, id_values[10000]);
+    ASSERT_EQ(9999.5, result.get(weights)[9999]);
+
+    return true;
+}
+
+// Main test runner
+int main() {
+    std::cout << "Running list parameter tests..." << std::endl;
+
+    RUN_TEST(test_repeated_strings);
+    RUN_TEST(test_numeric_lists);
+    RUN_TEST(test_interleaved_lists);
+    RUN_TEST(test_stateful_lists);
+    RUN_TEST(test_stateful_lists_outlive_tokens);
+    RUN_TEST(test_long_list_without_allocation);
+
+    print_test_summary();
+
+    return tests_failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,107 @@
+#include "allocation_counter.h"
+#include "argparse/parser.h"
+#include <string>
+#include <vector>
+
+using namespace argparse;
+
+static const int QUERY_COUNT = 1000000;
+
+// Test that looking up unknown names leaves the parser untouched
+bool test_lookup_misses_do_not_grow() {
+    parser p;
+    p.set_auto_help(false);
+    p.add_parameter("f", "file", "Input file", STRING, false, "default.txt");
+    p.add_parameter("n", "number", "A number", INTEGER, false, "0");
+    std::string help_before = p.get_help_message();
+    
+    const char* misses[] = {"nonexistent", "-x", "--nothere", "x", "", "-", "--", "--f", "-file"};
+    i64 value = 0;
+    long long before = allocation_count();
+    for (int i = 0; i < QUERY_COUNT; i++) {
+        for (const char* flag : misses) {
+            if (p.get_parameter_value_to(flag, &value)) {
+                return false;
+            }
+        }
+    }
+    ASSERT_EQ(0, allocation_count() - before);
+    ASSERT_STREQ(help_before, p.get_help_message());
+    
+    return true;
+}
+
+// Test that reading known values does not allocate
+bool test_lookup_hits_do_not_allocate() {
+    parser p;
+    p.set_auto_help(false);
+    p.add_parameter("v", "verbose", "Verbose mode", NONE, false);
+    p.add_parameter("n", "number", "A number", INTEGER, false, "42");
+    p.add_parameter("r", "rate", "A rate", FLOAT, false, "1.5");
+    
+    bool verbose = true;
+    i64 number = 0;
+    f64 rate = 0.0;
+    long long before = allocation_count();
+    for (int i = 0; i < QUERY_COUNT; i++) {
+        p.get_parameter_value_to("v", &verbose);
+        p.get_parameter_value_to("--number", &number);
+        p.get_parameter_value_to("rate", &rate);
+    }
+    ASSERT_EQ(0, allocation_count() - before);
+    ASSERT_FALSE(verbose);
+    ASSERT_EQ(42, number);
+    ASSERT_EQ(1.5, rate);
+    
+    return true;
+}
+
+// Test that the help probe after each parse does not grow a parser without help
+bool test_help_probe_does_not_grow() {
+    parser p;
+    p.add_parameter("v", "verbose", "Verbose mode", NONE, false);
+    
+    char program[] = "program";
+    char verbose[] = "-v";
+    char* argv[] = {program, verbose};
+    ASSERT_TRUE(p.parse(2, argv));
+    
+    long long before = allocation_count();
+    for (int i = 0; i < QUERY_COUNT; i++) {
+        if (!p.parse(2, argv)) {
+            return false;
+        }
+    }
+    ASSERT_EQ(0, allocation_count() - before);
+    
+    return true;
+}
+
+// Test that an "h" option which is not a flag is not mistaken for help
+bool test_help_probe_checks_type() {
+    parser p;
+    p.add_parameter("h", "height", "Height", INTEGER, false, "0");
+    
+    std::vector<std::string> args = {"program", "-h", "5"};
+    ASSERT_TRUE(p.parse(args));
+    
+    i64 height = 0;
+    ASSERT_TRUE(p.get_parameter_value_to("h", &height));
+    ASSERT_EQ(5, height);
+    
+    return true;
+}
+
+// Main test runner
+int main() {
+    std::cout << "Running lookup tests..." << std::endl;
+    
+    RUN_TEST(test_lookup_misses_do_not_grow);
+    RUN_TEST(test_lookup_hits_do_not_allocate);
+    RUN_TEST(test_help_probe_does_not_grow);
+    RUN_TEST(test_help_probe_checks_type);
+    
+    print_test_summary();
+    
+    return tests_failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,193 @@
+#include "allocation_counter.h"
+#include "test_fixtures.h"
+#include "argparse/parser.h"
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace argparse;
+
+// Test -DNAME=VALUE definitions, kept as views into argv
+bool test_defines() {
+    parser p;
+    p.set_auto_help(false);
+    handle<string_map> defines = p.add_parameter<string_map>("D", "define", "Define a macro");
+    handle<bool> verbose = p.add_parameter<bool>("v", "verbose", "Verbose mode");
+
+    const char* argv[] = {"cc", "-DNDEBUG", "-DLEVEL=2", "-v", "-D", "NAME=x", "--define=EXPR=a=b", "-DLEVEL=3"};
+    parse_result result;
+    ASSERT_TRUE(p.parse(8, argv, result));
+    ASSERT_TRUE(result.get(verbose));
+    string_map macros = result.get(defines);
+    // a key defined twice is stored once, with the last value
+    ASSERT_EQ(4, (i64)macros.size());
+    ASSERT_TRUE(macros.get("LEVEL") == "3");
+    ASSERT_TRUE(macros.get("NAME") == "x");
+    ASSERT_TRUE(macros.get("EXPR") == "a=b");
+    // a definition without '=' has an empty value
+    ASSERT_TRUE(macros.contains("NDEBUG"));
+    ASSERT_TRUE(macros.find("NDEBUG")->empty());
+    ASSERT_TRUE(macros.find("LEVEL=3") == nullptr);
+    ASSERT_TRUE(macros.get("MISSING", "none") == "none");
+    ASSERT_TRUE(macros.find("NAME")->data() == argv[5] + 5);
+
+    // entries keep the order in which each key was first defined
+    span<const map_entry> entries = macros.entries();
+    ASSERT_TRUE(entries[0].key == "NDEBUG");
+    ASSERT_TRUE(entries[1].key == "LEVEL");
+    ASSERT_TRUE(entries[1].value == "3");
+    ASSERT_TRUE(entries[3].key == "EXPR");
+    ASSERT_TRUE(result.is_set(defines));
+
+    ASSERT_TRUE(p.parse(1, argv, result));
+    ASSERT_TRUE(result.get(defines).empty());
+    ASSERT_FALSE(result.get(defines).contains("LEVEL"));
+    ASSERT_FALSE(result.is_set(defines));
+
+    return true;
+}
+
+// Test --set with dotted keys, defaults and invalid definitions
+bool test_settings() {
+    parser p;
+    p.set_auto_help(false);
+    handle<string_map> settings = p.add_parameter<string_map>("", "set", "Override a setting", false, "log.level=info");
+    handle<std::vector<std::string_view>> files = p.add_variadic("files", "Inputs");
+
+    parse_result result;
+    ASSERT_TRUE(p.parse(std::vector<std::string>{"tool"}, result));
+    ASSERT_EQ(1, (i64)result.get(settings).size());
+    ASSERT_TRUE(result.get(settings).get("log.level") == "info");
+
+    std::vector<std::string> args = {"tool", "--set", "db.host=local", "a", "--set=db.port=5432", "b"};
+    ASSERT_TRUE(p.parse(args, result));
+    string_map values = result.get(settings);
+    // given definitions replace the default
+    ASSERT_EQ(2, (i64)values.size());
+    ASSERT_FALSE(values.contains("log.level"));
+    ASSERT_TRUE(values.get("db.host") == "local");
+    ASSERT_TRUE(values.get("db.port") == "5432");
+    ASSERT_EQ(2, (i64)result.get(files).size());
+
+    ASSERT_FALSE(p.parse(std::vector<std::string>{"tool", "--set", "=x"}, result));
+    ASSERT_STREQ("error: invalid value =x for parameter set", result.get_error());
+    ASSERT_FALSE(p.parse(std::vector<std::string>{"tool", "--set"}, result));
+    ASSERT_STREQ("error: parameter set requires a value", result.get_error());
+
+    return true;
+}
+
+// Test the stateful parser, bound maps, lookups and streams
+bool test_stateful_maps() {
+    parser p;
+    p.set_auto_help(false);
+    string_map defines;
+    p.add_parameter("D", "define", "Define a macro", defines);
+    handle<string_map> settings = p.add_parameter<string_map>("", "set", "Override a setting");
+
+    std::vector<std::string> args = {"cc", "-DA=1", "--set", "x=y", "-DB", "-DA=2"};
+    ASSERT_TRUE(p.parse(args));
+    ASSERT_EQ(2, (i64)defines.size());
+    ASSERT_TRUE(defines.get("A") == "2");
+    ASSERT_TRUE(p.get(settings).get("x") == "y");
+    string_map copy;
+    ASSERT_TRUE(p.get_parameter_value_to("set", &copy));
+    ASSERT_TRUE(copy.get("x") == "y");
+
+    // streamed definitions are copied, as the stream's buffer is reused
+    std::istringstream in(std::string("-DFIRST=1\0--define=SECOND=2\0-D\0THIRD\0", 37));
+    token_stream tokens(in, '\0', 4);
+    ASSERT_TRUE(p.parse_stream(tokens));
+    ASSERT_EQ(3, (i64)defines.size());
+    ASSERT_TRUE(defines.get("FIRST") == "1");
+    ASSERT_TRUE(defines.get("SECOND") == "2");
+    ASSERT_TRUE(defines.contains("THIRD"));
+    ASSERT_FALSE(defines.contains("A"));
+    ASSERT_TRUE(p.get(settings).empty());
+
+    return true;
+}
+
+// Test that the stateful parser's maps outlive a temporary vector or argv
+bool test_stateful_maps_outlive_tokens() {
+    parser p;
+    p.set_auto_help(false);
+    handle<string_map> defines = p.add_parameter<string_map>("D", "define", "Define a macro");
+
+    ASSERT_TRUE(p.parse(std::vector<std::string>{"cc", "-DLEVEL=2", "--define=A_RATHER_LONG_MACRO_NAME=a-rather-long-value", "-DNDEBUG"}));
+    ASSERT_EQ(3, (i64)p.get(defines).size());
+    ASSERT_STREQ("2", p.get(defines).get("LEVEL"));
+    ASSERT_STREQ("a-rather-long-value", p.get(defines).get("A_RATHER_LONG_MACRO_NAME"));
+    ASSERT_TRUE(p.get(defines).contains("NDEBUG"));
+
+    std::vector<std::string>* tokens = new std::vector<std::string>{"cc", "-D", "LEVEL=3"};
+    std::vector<char*> argv;
+    for (std::string& token : *tokens) {
+        argv.push_back(&token[0]);
+    }
+    ASSERT_TRUE(p.parse((int)argv.size(), argv.data()));
+    delete tokens;
+    ASSERT_EQ(1, (i64)p.get(defines).size());
+    ASSERT_STREQ("3", p.get(defines).get("LEVEL"));
+    ASSERT_STREQ("LEVEL", p.get(defines).entries()[0].key);
+
+    return true;
+}
+
+// Test that thousands of definitions parse and are looked up without allocating
+bool test_many_defines_without_allocation() {
+    parser p;
+    p.set_auto_help(false);
+    handle<string_map> defines = p.add_parameter<string_map>("D", "define", "Define a macro");
+    handle<std::vector<std::string_view>> files = p.add_variadic("files", "Sources");
+    p.freeze();
+
+    std::vector<std::string> args = {"cc"};
+    for (int i = 0; i < 5000; i++) {
+        args.push_back("-DFEATURE_" + std::to_string(i) + "=" + std::to_string(i * 7));
+        if (i % 100 == 0) {
+            args.push_back("src/file" + std::to_string(i) + ".c");
+        }
+    }
+    // redefinitions update the first entry of their key
+    args.push_back("-DFEATURE_0=last");
+    std::vector<const char*> argv = pointers(args);
+
+    parse_result result;
+    ASSERT_TRUE(p.parse((int)argv.size(), argv.data(), result));
+    ASSERT_NO_ALLOCATIONS(p.parse((int)argv.size(), argv.data(), result));
+    string_map macros = result.get(defines);
+    ASSERT_EQ(5000, (i64)macros.size());
+    ASSERT_EQ(50, (i64)result.get(files).size());
+    ASSERT_TRUE(macros.get("FEATURE_0") == "last");
+    ASSERT_TRUE(macros.get("FEATURE_4999") == "34993");
+
+    u64 found = 0;
+    auto look_up_all = [&]() {
+        for (const map_entry& entry : macros.entries()) {
+            found += macros.find(entry.key) == &entry.value ? 1 : 0;
+            found += macros.contains(entry.key.substr(0, entry.key.size() - 1)) ? 1 : 0;
+        }
+    };
+    ASSERT_NO_ALLOCATIONS(look_up_all());
+    // every key is found, and so is FEATURE_N without its last digit when N
+    // has two or more digits
+    ASSERT_EQ(5000 + 4990, (i64)found);
+
+    return true;
+}
+
+// Main test runner
+int main() {
+    std::cout << "Running map parameter tests..." << std::endl;
+
+    RUN_TEST(test_defines);
+    RUN_TEST(test_settings);
+    RUN_TEST(test_stateful_maps);
+    RUN_TEST(test_stateful_maps_outlive_tokens);
+    RUN_TEST(test_many_defines_without_allocation);
+
+    print_test_summary();
+
+    return tests_failed > 0 ? 1 : 0;
+}
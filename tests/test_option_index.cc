@@ -0,0 +1,240 @@
+#include "test_framework.h"
+#include "argparse/option_index.h"
+#include "argparse/parser.h"
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace argparse;
+
+// Test single character short names
+bool test_option_index_short_names() {
+    option_index index;
+    ASSERT_EQ(-1, index.find_short("a"));
+    
+    index.add_short("a", 0);
+    index.add_short("Z", 1);
+    index.add_short("\xff", 2);
+    ASSERT_EQ(0, index.find_short("a"));
+    ASSERT_EQ(1, index.find_short("Z"));
+    ASSERT_EQ(2, index.find_short("\xff"));
+    ASSERT_EQ(-1, index.find_short("b"));
+    ASSERT_EQ(-1, index.find_short(""));
+    
+    // Short and long names live in separate namespaces
+    ASSERT_EQ(-1, index.find_long("a"));
+    
+    return true;
+}
+
+// Test short names longer than one character
+bool test_option_index_multi_char_short_names() {
+    option_index index;
+    index.add_short("ab", 3);
+    index.add_short("a", 4);
+    ASSERT_EQ(3, index.find_short("ab"));
+    ASSERT_EQ(4, index.find_short("a"));
+    ASSERT_EQ(-1, index.find_short("abc"));
+    
+    return true;
+}
+
+// Test long names
+bool test_option_index_long_names() {
+    option_index index;
+    ASSERT_EQ(-1, index.find_long("help"));
+    
+    index.add_long("help", 0);
+    index.add_long("file", 1);
+    ASSERT_EQ(0, index.find_long("help"));
+    ASSERT_EQ(1, index.find_long("file"));
+    ASSERT_EQ(-1, index.find_long("hel"));
+    ASSERT_EQ(-1, index.find_long("helpx"));
+    ASSERT_EQ(-1, index.find_long(""));
+    
+    return true;
+}
+
+// Test that re-registering a name points it at the newest id
+bool test_option_index_reregister() {
+    option_index index;
+    index.add_long("file", 0);
+    index.add_long("file", 7);
+    index.add_short("f", 0);
+    index.add_short("f", 7);
+    ASSERT_EQ(7, index.find_long("file"));
+    ASSERT_EQ(7, index.find_short("f"));
+    
+    index.clear();
+    ASSERT_EQ(-1, index.find_long("file"));
+    ASSERT_EQ(-1, index.find_short("f"));
+    
+    return true;
+}
+
+// Test lookups while the table grows to thousands of names
+bool test_option_index_many_names() {
+    std::vector<std::string> names;
+    for (int i = 0; i < 5000; i++) {
+        names.push_back("option-" + std::to_string(i));
+    }
+    
+    option_index index;
+    for (int i = 0; i < 5000; i++) {
+        index.add_long(names[i], i);
+    }
+    for (int i = 0; i < 5000; i++) {
+        ASSERT_EQ(i, index.find_long(names[i]));
+    }
+    ASSERT_EQ(-1, index.find_long("option-5000"));
+    
+    return true;
+}
+
+// Test a parser with several hundred options
+bool test_parser_many_options() {
+    parser p;
+    p.set_auto_help(false);
+    for (int i = 0; i < 500; i++) {
+        p.add_parameter("", "opt" + std::to_string(i), "Option", INTEGER, false, "0");
+    }
+    
+    std::vector<std::string> args = {"program", "--opt0", "10", "--opt250", "20", "--opt499", "30"};
+    ASSERT_TRUE(p.parse(args));
+    
+    i64 value = 0;
+    ASSERT_TRUE(p.get_parameter_value_to("opt0", &value));
+    ASSERT_EQ(10, value);
+    ASSERT_TRUE(p.get_parameter_value_to("--opt250", &value));
+    ASSERT_EQ(20, value);
+    ASSERT_TRUE(p.get_parameter_value_to("opt499", &value));
+    ASSERT_EQ(30, value);
+    ASSERT_TRUE(p.get_parameter_value_to("opt1", &value));
+    ASSERT_EQ(0, value);
+    ASSERT_FALSE(p.get_parameter_value_to("opt500", &value));
+    
+    return true;
+}
+
+// Test that registering the same names again replaces the option
+bool test_parser_replace_option() {
+    parser p;
+    p.set_auto_help(false);
+    p.add_parameter("f", "file", "Old description", STRING, false, "old.txt");
+    p.add_parameter("f", "file", "New description", STRING, false, "new.txt");
+    
+    std::string file_value;
+    ASSERT_TRUE(p.get_parameter_value_to("f", &file_value));
+    ASSERT_STREQ("new.txt", file_value);
+    
+    std::string help_msg = p.get_help_message();
+    ASSERT_TRUE(help_msg.find("New description") != std::string::npos);
+    ASSERT_TRUE(help_msg.find("Old description") == std::string::npos);
+    
+    return true;
+}
+
+// Test that the same names with another type list only the new option in help
+bool test_parser_replace_option_type() {
+    parser p;
+    p.set_auto_help(false);
+    handle<i64> number = p.add_parameter<i64>("n", "num", "A number", false, "3");
+    handle<std::string> text = p.add_parameter<std::string>("n", "num", "A text", false, "x");
+    p.add_parameter("", "only", "Long only", INTEGER, false, "1");
+    p.add_parameter("", "only", "Long only text", STRING, false, "y");
+    
+    std::string help_msg = p.get_help_message();
+    ASSERT_TRUE(help_msg.find("A text") != std::string::npos);
+    ASSERT_TRUE(help_msg.find("A number") == std::string::npos);
+    ASSERT_TRUE(help_msg.find("Long only text") != std::string::npos);
+    ASSERT_EQ(help_msg.find("-n, --num"), help_msg.rfind("-n, --num"));
+    ASSERT_EQ(help_msg.find("--only"), help_msg.rfind("--only"));
+    
+    // the names reach the new option, the old handle keeps its default
+    ASSERT_TRUE(p.parse(std::vector<std::string>{"program", "-n", "abc", "--only", "z"}));
+    ASSERT_STREQ("abc", p.get(text));
+    ASSERT_EQ(3, p.get(number));
+    std::string only;
+    ASSERT_TRUE(p.get_parameter_value_to("only", &only));
+    ASSERT_STREQ("z", only);
+    
+    return true;
+}
+
+// Test that a name used by another option is rejected, not registered twice
+bool test_parser_conflicting_names() {
+    parser p;
+    p.set_auto_help(false);
+    handle<bool> all = p.add_parameter<bool>("a", "all", "All files");
+    p.add_parameter<bool>("", "verbose", "Verbose");
+    ASSERT_FALSE(p.add_parameter<bool>("a", "any", "Any file").is_valid());
+    ASSERT_FALSE(p.add_parameter<bool>("x", "all", "Other").is_valid());
+    ASSERT_FALSE(p.add_parameter<bool>("a", "", "Short only").is_valid());
+    // each name belongs to a different option
+    ASSERT_FALSE(p.add_parameter<bool>("a", "verbose", "Both").is_valid());
+    p.add_parameter("a", "any", "Any file", NONE, false);
+    
+    std::string help_msg = p.get_help_message();
+    ASSERT_TRUE(help_msg.find("--any") == std::string::npos);
+    ASSERT_TRUE(help_msg.find("Other") == std::string::npos);
+    bool value = false;
+    ASSERT_FALSE(p.get_parameter_value_to("any", &value));
+    ASSERT_TRUE(p.parse(std::vector<std::string>{"program", "-a"}));
+    ASSERT_TRUE(p.get(all));
+    
+    // the untyped overload reports the conflict, as does the typed one
+    std::ostringstream errors;
+    std::streambuf* console = std::cerr.rdbuf(errors.rdbuf());
+    p.add_parameter("a", "other", "Other", NONE, false);
+    bool typed_valid = p.add_parameter<bool>("", "all", "Long only").is_valid();
+    std::cerr.rdbuf(console);
+    ASSERT_FALSE(typed_valid);
+    ASSERT_STREQ("error: parameter other shares a name with parameter all\n"
+                 "error: parameter all shares a name with parameter all\n", errors.str());
+    ASSERT_FALSE(p.get_parameter_value_to("other", &value));
+    
+    // the same names again still replace the option
+    ASSERT_EQ(all.get_id(), p.add_parameter<bool>("a", "all", "All of them").get_id());
+    handle<bool> quiet = p.add_parameter<bool>("q", "", "Quiet");
+    ASSERT_EQ(quiet.get_id(), p.add_parameter<bool>("q", "", "Less output").get_id());
+    
+    return true;
+}
+
+// Test that help lists options sorted by name, not by registration order
+bool test_parser_help_order() {
+    parser p;
+    p.add_parameter("v", "verbose", "Verbose", NONE, false);
+    p.add_parameter("a", "all", "All", NONE, false);
+    p.add_parameter("", "zeta", "Zeta", NONE, false);
+    
+    std::string help_msg = p.get_help_message();
+    size_t zeta = help_msg.find("--zeta");
+    size_t all = help_msg.find("-a, --all");
+    size_t verbose = help_msg.find("-v, --verbose");
+    ASSERT_TRUE(zeta != std::string::npos);
+    ASSERT_TRUE(zeta < all);
+    ASSERT_TRUE(all < verbose);
+    
+    return true;
+}
+
+// Main test runner
+int main() {
+    std::cout << "Running option index tests..." << std::endl;
+    
+    RUN_TEST(test_option_index_short_names);
+    RUN_TEST(test_option_index_multi_char_short_names);
+    RUN_TEST(test_option_index_long_names);
+    RUN_TEST(test_option_index_reregister);
+    RUN_TEST(test_option_index_many_names);
+    RUN_TEST(test_parser_many_options);
+    RUN_TEST(test_parser_replace_option);
+    RUN_TEST(test_parser_replace_option_type);
+    RUN_TEST(test_parser_conflicting_names);
+    RUN_TEST(test_parser_help_order);
+    
+    print_test_summary();
+    
+    return tests_failed > 0 ? 1 : 0;
+}
@@ -102,6 +102,23 @@ bool test_parameter_integer_unsigned() {
     return true;
 }
 
+// Test that bad integer text is rejected without changing the value
+bool test_parameter_integer_invalid() {
+    parameter_integer p("n", "number", "A number");
+    ASSERT_TRUE(p.set("12"));
+    ASSERT_FALSE(p.set("12abc"));
+    ASSERT_FALSE(p.set(""));
+    ASSERT_FALSE(p.set("99999999999999999999"));
+    ASSERT_EQ(12, p.get_value());
+    
+    parameter_integer p_unsigned("u", "unsigned", "Unsigned number", 10, false);
+    ASSERT_FALSE(p_unsigned.set("-1"));
+    ASSERT_TRUE(p_unsigned.set("18446744073709551615"));
+    ASSERT_EQ(-1, p_unsigned.get_value());
+    
+    return true;
+}
+
 // Test parameter_string
 bool test_parameter_string_construction() {
     parameter_string p("s", "string", "A string");
@@ -169,6 +186,40 @@ bool test_parameter_float_set_get() {
     return true;
 }
 
+// Test parameters storing their values in a bound variable
+bool test_parameter_bind() {
+    parameter_integer p_int("n", "number", "A number");
+    i64 number = 5;
+    p_int.bind(&number);
+    ASSERT_EQ(5, p_int.get_value());
+    p_int.set("123");
+    ASSERT_EQ(123, number);
+    
+    parameter_string p_str("s", "string", "A string");
+    std::string text;
+    p_str.bind(&text);
+    p_str.set("hello");
+    ASSERT_STREQ("hello", text);
+    ASSERT_TRUE(&p_str.get_value() == &text);
+    
+    parameter_none p_none("h", "help", "Show help");
+    bool help = false;
+    p_none.bind(&help);
+    p_none.set("");
+    ASSERT_TRUE(help);
+    
+    parameter_float p_float("f", "float", "A float");
+    f64 rate = 0.0;
+    p_float.bind(&rate);
+    p_float.set("2.5");
+    f64 value = 0.0;
+    p_float.get_value_to(&value);
+    ASSERT_EQ(2.5, rate);
+    ASSERT_EQ(2.5, value);
+    
+    return true;
+}
+
 // Test parameter names with empty values
 bool test_parameter_empty_names() {
     // Parameter with only short name
@@ -195,11 +246,13 @@ int main() {
     RUN_TEST(test_parameter_integer_set_get);
     RUN_TEST(test_parameter_integer_different_bases);
     RUN_TEST(test_parameter_integer_unsigned);
+    RUN_TEST(test_parameter_integer_invalid);
     RUN_TEST(test_parameter_string_construction);
     RUN_TEST(test_parameter_string_set_get);
     RUN_TEST(test_parameter_float_construction);
     RUN_TEST(test_parameter_float_set_get);
     RUN_TEST(test_parameter_empty_names);
+    RUN_TEST(test_parameter_bind);
     
     print_test_summary();
     
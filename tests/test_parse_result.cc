@@ -0,0 +1,318 @@
+#include "test_framework.h"
+#include "argparse/parser.h"
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace argparse;
+
+// Test parsing into a result leaves the parser untouched
+bool test_parse_result_basic() {
+    parser p;
+    handle<bool> verbose = p.add_parameter<bool>("v", "verbose", "Verbose mode");
+    handle<i64> number = p.add_parameter<i64>("n", "number", "A number", false, "42");
+    handle<f64> rate = p.add_parameter<f64>("r", "rate", "A rate", false, "0.5");
+    handle<std::string> file = p.add_parameter<std::string>("f", "file", "Input file", false, "default.txt");
+    
+    std::vector<std::string> args = {"/usr/bin/program", "-v", "--number", "7", "-f", "test.txt"};
+    parse_result result;
+    ASSERT_TRUE(p.parse(args, result));
+    
+    ASSERT_TRUE(result.get(verbose));
+    ASSERT_EQ(7, result.get(number));
+    ASSERT_EQ(0.5, result.get(rate));
+    ASSERT_TRUE(result.get(file) == "test.txt");
+    ASSERT_TRUE(result.get_program_name() == "program");
+    ASSERT_TRUE(result.is_set(number));
+    ASSERT_FALSE(result.is_set(rate));
+    
+    // String values point into the parsed tokens
+    ASSERT_TRUE(result.get(file).data() == args[5].data());
+    
+    // Name lookups on the result
+    i64 number_value = 0;
+    ASSERT_TRUE(result.get_parameter_value_to("--number", &number_value));
+    ASSERT_EQ(7, number_value);
+    std::string file_value;
+    ASSERT_TRUE(result.get_parameter_value_to("file", &file_value));
+    ASSERT_STREQ("test.txt", file_value);
+    ASSERT_FALSE(result.get_parameter_value_to("missing", &number_value));
+    
+    // The parser still holds its defaults
+    ASSERT_FALSE(p.get(verbose));
+    ASSERT_EQ(42, p.get(number));
+    ASSERT_STREQ("default.txt", p.get(file));
+    
+    return true;
+}
+
+// Test that reusing a result does not keep values from the previous parse
+bool test_parse_result_reuse() {
+    parser p;
+    handle<i64> number = p.add_parameter<i64>("n", "number", "A number", false, "42");
+    handle<std::string> file = p.add_parameter<std::string>("f", "file", "Input file", false, "default.txt");
+    
+    const char* argv1[] = {"program", "-n", "1", "-f", "a.txt"};
+    const char* argv2[] = {"program"};
+    parse_result result;
+    ASSERT_TRUE(p.parse(5, argv1, result));
+    ASSERT_EQ(1, result.get(number));
+    ASSERT_TRUE(result.get(file) == "a.txt");
+    
+    ASSERT_TRUE(p.parse(1, argv2, result));
+    ASSERT_EQ(42, result.get(number));
+    ASSERT_TRUE(result.get(file) == "default.txt");
+    ASSERT_FALSE(result.is_set(number));
+    
+    return true;
+}
+
+// Test that a reused result resets every kind of value, also after a failed
+// parse, a change of defaults or a parse with another parser
+bool test_parse_result_reuse_every_kind() {
+    parser p;
+    handle<i64> number = p.add_parameter<i64>("n", "number", "A number", false, "42");
+    handle<std::vector<i64>> sizes = p.add_parameter<std::vector<i64>>("s", "sizes", "Sizes", false, "1,2");
+    handle<string_map> defines = p.add_parameter<string_map>("D", "define", "Definition", false, "MODE=debug");
+    handle<flag_set> features = p.add_flag_family("feature", "-f", "-fno-", "Features");
+    i32 rtti = p.add_flag(features, "rtti", true);
+    i32 pic = p.add_flag(features, "pic");
+    handle<i64> jobs = p.add_positional<i64>("jobs", "Parallel jobs", false, "4");
+    handle<std::vector<std::string_view>> files = p.add_variadic("files", "Input files");
+    
+    std::vector<std::string> full = {"program", "-n", "1", "-s", "5", "-DMODE=release", "-DLEVEL=3", "-fno-rtti", "-fpic", "8", "a.c", "b.c"};
+    std::vector<std::string> empty = {"program"};
+    parse_result result;
+    for (int round = 0; round < 2; round++) {
+        ASSERT_TRUE(p.parse(full, result));
+        ASSERT_EQ(1, result.get(number));
+        ASSERT_EQ(1u, result.get(sizes).size());
+        ASSERT_TRUE(*result.get(defines).find("MODE") == "release");
+        ASSERT_FALSE(result.get(features).test(rtti));
+        ASSERT_TRUE(result.get(features).test(pic));
+        ASSERT_EQ(8, result.get(jobs));
+        ASSERT_EQ(2u, result.get(files).size());
+        
+        ASSERT_TRUE(p.parse(empty, result));
+        ASSERT_EQ(42, result.get(number));
+        ASSERT_EQ(2u, result.get(sizes).size());
+        ASSERT_EQ(2, result.get(sizes)[1]);
+        ASSERT_EQ(1u, result.get(defines).size());
+        ASSERT_TRUE(*result.get(defines).find("MODE") == "debug");
+        ASSERT_TRUE(result.get(features).test(rtti));
+        ASSERT_FALSE(result.get(features).test(pic));
+        ASSERT_EQ(4, result.get(jobs));
+        ASSERT_EQ(0u, result.get(files).size());
+        ASSERT_FALSE(result.is_set(number));
+        ASSERT_FALSE(result.is_set(files));
+    }
+    
+    // a failed parse leaves nothing behind for the next one
+    std::vector<std::string> failing = {"program", "-n", "2", "-fno-rtti", "-s", "x"};
+    ASSERT_FALSE(p.parse(failing, result));
+    ASSERT_TRUE(p.parse(empty, result));
+    ASSERT_EQ(42, result.get(number));
+    ASSERT_TRUE(result.get(features).test(rtti));
+    
+    // new defaults are picked up by the next parse
+    handle<i64> level = p.add_parameter<i64>("l", "level", "Level", false, "3");
+    p.add_parameter<i64>("n", "number", "A number", false, "43");
+    ASSERT_TRUE(p.parse(empty, result));
+    ASSERT_EQ(43, result.get(number));
+    ASSERT_EQ(3, result.get(level));
+    
+    // a result moves between parsers
+    parser other;
+    handle<i64> count = other.add_parameter<i64>("n", "count", "A count", false, "9");
+    ASSERT_TRUE(other.parse(empty, result));
+    ASSERT_EQ(9, result.get(count));
+    ASSERT_TRUE(p.parse(empty, result));
+    ASSERT_EQ(43, result.get(number));
+    
+    return true;
+}
+
+// Test errors are reported through the result
+bool test_parse_result_errors() {
+    parser p;
+    p.add_parameter("n", "number", "A number", INTEGER, false, "0");
+    
+    // Auto-help is enabled, yet a const parse never prints help or exits
+    parse_result result;
+    std::vector<std::string> args = {"program", "--unknown"};
+    ASSERT_FALSE(p.parse(args, result));
+    ASSERT_STREQ("error: unknown parameter unknown", result.get_error());
+    
+    args = {"program", "-n"};
+    ASSERT_FALSE(p.parse(args, result));
+    ASSERT_STREQ("error: parameter n requires a value", result.get_error());
+    
+    args = {"program", "-n", "x1"};
+    ASSERT_FALSE(p.parse(args, result));
+    ASSERT_STREQ("error: invalid value x1 for parameter n", result.get_error());
+    
+    args = {"program", "stray"};
+    ASSERT_FALSE(p.parse(args, result));
+    ASSERT_STREQ("error: unexpected argument stray", result.get_error());
+    
+    args = {"program", "-n", "3"};
+    ASSERT_TRUE(p.parse(args, result));
+    ASSERT_STREQ("", result.get_error());
+    
+    return true;
+}
+
+// Test many threads parsing against one shared parser
+bool test_parse_result_concurrent() {
+    parser p;
+    handle<i64> number = p.add_parameter<i64>("n", "number", "A number", false, "0");
+    handle<std::string> name = p.add_parameter<std::string>("s", "name", "A name", false, "");
+    handle<bool> verbose = p.add_parameter<bool>("v", "verbose", "Verbose mode");
+    const parser& spec = p;
+    
+    const int thread_count = 8;
+    const int parses_per_thread = 2000;
+    std::vector<int> failures(thread_count, 0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < thread_count; t++) {
+        threads.emplace_back([&, t]() {
+            parse_result result;
+            for (int i = 0; i < parses_per_thread; i++) {
+                std::string value = std::to_string(t * parses_per_thread + i);
+                std::vector<std::string> args = {"program", "--number", value, "--name", "thread" + std::to_string(t)};
+                if (t % 2 == 0) {
+                    args.push_back("-v");
+                }
+                if (!spec.parse(args, result) ||
+                    result.get(number) != t * parses_per_thread + i ||
+                    result.get(name) != "thread" + std::to_string(t) ||
+                    result.get(verbose) != (t % 2 == 0)) {
+                    failures[t]++;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (int t = 0; t < thread_count; t++) {
+        ASSERT_EQ(0, failures[t]);
+    }
+    
+    return true;
+}
+
+// Test that the stateful parse no longer keeps values from an earlier parse
+bool test_parser_parse_resets_values() {
+    parser p;
+    p.set_auto_help(false);
+    p.add_parameter("n", "number", "A number", INTEGER, false, "42");
+    p.add_parameter("v", "verbose", "Verbose mode", NONE, false);
+    std::string output = "out.txt";
+    p.add_parameter("o", "output", "Output file", output);
+    
+    std::vector<std::string> args = {"program", "-n", "5", "-v", "-o", "other.txt"};
+    ASSERT_TRUE(p.parse(args));
+    i64 number = 0;
+    bool verbose = false;
+    ASSERT_TRUE(p.get_parameter_value_to("n", &number));
+    ASSERT_TRUE(p.get_parameter_value_to("v", &verbose));
+    ASSERT_EQ(5, number);
+    ASSERT_TRUE(verbose);
+    ASSERT_STREQ("other.txt", output);
+    
+    args = {"program"};
+    ASSERT_TRUE(p.parse(args));
+    ASSERT_TRUE(p.get_parameter_value_to("n", &number));
+    ASSERT_TRUE(p.get_parameter_value_to("v", &verbose));
+    ASSERT_EQ(42, number);
+    ASSERT_FALSE(verbose);
+    ASSERT_STREQ("out.txt", output);
+    
+    // A failed parse leaves the previous values in place
+    args = {"program", "-n", "6", "--unknown"};
+    ASSERT_FALSE(p.parse(args));
+    ASSERT_TRUE(p.get_parameter_value_to("n", &number));
+    ASSERT_EQ(42, number);
+    
+    // an option added between parses holds its default after the next one
+    handle<i64> level = p.add_parameter<i64>("l", "level", "Level", false, "3");
+    args = {"program", "-v"};
+    ASSERT_TRUE(p.parse(args));
+    ASSERT_EQ(3, p.get(level));
+    args = {"program", "-l", "5"};
+    ASSERT_TRUE(p.parse(args));
+    ASSERT_EQ(5, p.get(level));
+    ASSERT_TRUE(p.get_parameter_value_to("v", &verbose));
+    ASSERT_FALSE(verbose);
+    
+    return true;
+}
+
+// Test the value table entries and their conversion to slots
+bool test_value_table() {
+    value_table values;
+    values.push_back();
+    values.push_back();
+    values.push_back();
+    ASSERT_EQ(3u, values.size());
+    ASSERT_EQ(8u, sizeof(value_cell));
+    
+    value_slot slot = value_slot();
+    slot.present = true;
+    slot.integer = -7;
+    values.set_slot(0, INTEGER, slot);
+    slot = value_slot();
+    slot.text = "text";
+    values.set_slot(1, STRING, slot);
+    slot = value_slot();
+    slot.flag = true;
+    values.set_slot(2, NONE, slot);
+    
+    ASSERT_EQ(value_table::PRESENT, values.states[0]);
+    ASSERT_EQ(-7, values.cells[0].integer);
+    ASSERT_EQ(0, values.states[1]);
+    ASSERT_TRUE(values.texts[1] == "text");
+    ASSERT_TRUE(values.get_slot(2, NONE).flag);
+    ASSERT_EQ(-7, values.get_slot(0, INTEGER).integer);
+    ASSERT_TRUE(values.get_slot(0, INTEGER).present);
+    
+    value_table copy;
+    copy.assign(values);
+    values.reset(0);
+    ASSERT_EQ(0, values.states[0]);
+    ASSERT_EQ(0, values.cells[0].integer);
+    ASSERT_EQ(-7, copy.cells[0].integer);
+    ASSERT_TRUE(copy.texts[1] == "text");
+    
+    // restore resets the touched entries and drops appended items
+    copy.touch(1);
+    copy.texts[1] = "changed";
+    copy.items.push_back("item");
+    copy.touch(1);
+    ASSERT_EQ(1u, copy.touched.size());
+    copy.restore(values);
+    ASSERT_TRUE(copy.texts[1] == "text");
+    ASSERT_EQ(0u, copy.items.size());
+    ASSERT_EQ(0u, copy.touched.size());
+    ASSERT_EQ(0, copy.states[1] & value_table::TOUCHED);
+    
+    return true;
+}
+
+// Main test runner
+int main() {
+    std::cout << "Running parse result tests..." << std::endl;
+    
+    RUN_TEST(test_parse_result_basic);
+    RUN_TEST(test_parse_result_reuse);
+    RUN_TEST(test_parse_result_reuse_every_kind);
+    RUN_TEST(test_parse_result_errors);
+    RUN_TEST(test_parse_result_concurrent);
+    RUN_TEST(test_parser_parse_resets_values);
+    RUN_TEST(test_value_table);
+    
+    print_test_summary();
+    
+    return tests_failed > 0 ? 1 : 0;
+}
@@ -39,6 +39,7 @@ bool test_add_parameter_float() {
 // Test parsing simple flag
 bool test_parse_short_flag() {
     parser p;
+    p.set_auto_help(false);
     p.add_parameter("h", "help", "Show help message", NONE, false);
     
     std::vector<std::string> args = {"program", "-h"};
@@ -55,6 +56,7 @@ bool test_parse_short_flag() {
 
 bool test_parse_long_flag() {
     parser p;
+    p.set_auto_help(false);
     p.add_parameter("h", "help", "Show help message", NONE, false);
     
     std::vector<std::string> args = {"program", "--help"};
@@ -72,6 +74,7 @@ bool test_parse_long_flag() {
 // Test parsing string parameter
 bool test_parse_string_parameter() {
     parser p;
+    p.set_auto_help(false);
     p.add_parameter("f", "file", "Input file", STRING, false, "default.txt");
     
     std::vector<std::string> args = {"program", "-f", "test.txt"};
@@ -88,6 +91,7 @@ bool test_parse_string_parameter() {
 
 bool test_parse_string_parameter_long() {
     parser p;
+    p.set_auto_help(false);
     p.add_parameter("f", "file", "Input file", STRING, false, "default.txt");
     
     std::vector<std::string> args = {"program", "--file", "test.txt"};
@@ -105,6 +109,7 @@ bool test_parse_string_parameter_long() {
 // Test parsing integer parameter
 bool test_parse_integer_parameter() {
     parser p;
+    p.set_auto_help(false);
     p.add_parameter("n", "number", "A number", INTEGER, false, "0");
     
     std::vector<std::string> args = {"program", "-n", "123"};
@@ -122,6 +127,7 @@ bool test_parse_integer_parameter() {
 // Test parsing float parameter
 bool test_parse_float_parameter() {
     parser p;
+    p.set_auto_help(false);
     p.add_parameter("r", "rate", "A rate", FLOAT, false, "0.0");
     
     std::vector<std::string> args = {"program", "-r", "3.14"};
@@ -139,6 +145,7 @@ bool test_parse_float_parameter() {
 // Test parsing multiple parameters
 bool test_parse_multiple_parameters() {
     parser p;
+    p.set_auto_help(false);
     p.add_parameter("h", "help", "Show help", NONE, false);
     p.add_parameter("f", "file", "Input file", STRING, false, "default.txt");
     p.add_parameter("n", "number", "A number", INTEGER, false, "0");
@@ -165,6 +172,7 @@ bool test_parse_multiple_parameters() {
 // Test parsing with argc/argv interface
 bool test_parse_argc_argv() {
     parser p;
+    p.set_auto_help(false);
     p.add_parameter("h", "help", "Show help message", NONE, false);
     
     const char* argv[] = {"program", "-h"};
@@ -186,9 +194,64 @@ bool test_parse_argc_argv() {
     return true;
 }
 
+// Test parsing values straight from argv
+bool test_parse_argc_argv_values() {
+    parser p;
+    p.set_auto_help(false);
+    p.add_parameter("f", "file", "Input file", STRING, false, "default.txt");
+    p.add_parameter("n", "number", "A number", INTEGER, false, "0");
+    
+    char program[] = "/usr/bin/program";
+    char file_flag[] = "--file";
+    char file_name[] = "a_file_name_long_enough_to_leave_small_string_storage.txt";
+    char number_flag[] = "-n";
+    char number[] = "-";
+    char* argv[] = {program, file_flag, file_name, number_flag, number};
+    
+    // "-" is taken as the value, which is not a number
+    ASSERT_FALSE(p.parse(5, argv));
+    
+    number[0] = '7';
+    ASSERT_TRUE(p.parse(5, argv));
+    
+    std::string file_value;
+    ASSERT_TRUE(p.get_parameter_value_to("file", &file_value));
+    ASSERT_STREQ(file_name, file_value);
+    
+    i64 number_value;
+    ASSERT_TRUE(p.get_parameter_value_to("n", &number_value));
+    ASSERT_EQ(7, number_value);
+    
+    // The stored value is owned by the parser, not by argv
+    file_name[0] = 'X';
+    ASSERT_TRUE(p.get_parameter_value_to("file", &file_value));
+    ASSERT_EQ('a', file_value[0]);
+    
+    return true;
+}
+
+// Test that parsing does not modify the caller's arguments
+bool test_parse_keeps_args() {
+    parser p;
+    p.set_auto_help(false);
+    p.add_parameter("f", "file", "Input file", STRING, false, "default.txt");
+    
+    const std::vector<std::string> args = {"program", "-f", "test.txt"};
+    ASSERT_TRUE(p.parse(args));
+    ASSERT_EQ(3u, args.size());
+    ASSERT_STREQ("program", args[0]);
+    
+    // Empty argument list is accepted
+    std::vector<std::string> empty;
+    ASSERT_TRUE(p.parse(empty));
+    
+    return true;
+}
+
 // Test error handling - unknown parameter
 bool test_parse_unknown_parameter() {
     parser p;
+    p.set_auto_help(false);
     p.add_parameter("h", "help", "Show help message", NONE, false);
     
     std::vector<std::string> args = {"program", "-x"};
@@ -201,6 +264,7 @@ bool test_parse_unknown_parameter() {
 // Test error handling - missing value
 bool test_parse_missing_value() {
     parser p;
+    p.set_auto_help(false);
     p.add_parameter("f", "file", "Input file", STRING, false, "default.txt");
     
     std::vector<std::string> args = {"program", "-f"};
@@ -213,6 +277,7 @@ bool test_parse_missing_value() {
 // Test help message generation
 bool test_help_message() {
     parser p;
+    p.set_auto_help(false);
     p.add_parameter("h", "help", "Show help message", NONE, false);
     p.add_parameter("f", "file", "Input file", STRING, false, "default.txt");
     
@@ -242,6 +307,232 @@ bool test_get_nonexistent_parameter() {
     return true;
 }
 
+// Test reading values through typed handles
+bool test_typed_handles() {
+    parser p;
+    p.set_auto_help(false);
+    handle<bool> verbose = p.add_parameter<bool>("v", "verbose", "Verbose mode");
+    handle<i64> number = p.add_parameter<i64>("n", "number", "A number", false, "42");
+    handle<f64> rate = p.add_parameter<f64>("r", "rate", "A rate", false, "0.5");
+    handle<std::string> file = p.add_parameter<std::string>("f", "file", "Input file", false, "default.txt");
+    ASSERT_TRUE(verbose.is_valid());
+    ASSERT_TRUE(number.is_valid());
+    ASSERT_TRUE(rate.is_valid());
+    ASSERT_TRUE(file.is_valid());
+    
+    // Defaults, which freeze converts before the first parse
+    ASSERT_TRUE(p.freeze());
+    ASSERT_FALSE(p.get(verbose));
+    ASSERT_EQ(42, p.get(number));
+    ASSERT_EQ(0.5, p.get(rate));
+    ASSERT_STREQ("default.txt", p.get(file));
+    
+    std::vector<std::string> args = {"program", "-v", "--number", "7", "-r", "2.5", "--file", "test.txt"};
+    ASSERT_TRUE(p.parse(args));
+    ASSERT_TRUE(p.get(verbose));
+    ASSERT_EQ(7, p.get(number));
+    ASSERT_EQ(2.5, p.get(rate));
+    
+    // Strings are returned by reference to the parser's storage
+    const std::string& file_value = p.get(file);
+    ASSERT_STREQ("test.txt", file_value);
+    ASSERT_TRUE(&file_value == &p.get(file));
+    
+    return true;
+}
+
+// Test that typed and untyped registration are interchangeable
+bool test_typed_handles_with_untyped_lookup() {
+    parser p;
+    p.set_auto_help(false);
+    handle<i64> count = p.add_parameter<i64>("c", "count", "A count", false, "3");
+    
+    i64 value = 0;
+    ASSERT_TRUE(p.get_parameter_value_to("count", &value));
+    ASSERT_EQ(3, value);
+    
+    // Re-registering with the same names and type keeps the handle usable
+    p.add_parameter("c", "count", "A count", INTEGER, false, "9");
+    ASSERT_TRUE(p.freeze());
+    ASSERT_EQ(9, p.get(count));
+    
+    // Re-registering with another type leaves the old handle's option alone
+    handle<std::string> name = p.add_parameter<std::string>("c", "count", "A name", false, "x");
+    ASSERT_TRUE(name.get_id() != count.get_id());
+    ASSERT_TRUE(p.freeze());
+    ASSERT_EQ(9, p.get(count));
+    ASSERT_STREQ("x", p.get(name));
+    
+    // A default constructed handle refers to nothing
+    handle<i64> empty;
+    ASSERT_FALSE(empty.is_valid());
+    
+    return true;
+}
+
+// Test options bound to caller-owned variables
+bool test_bound_variables() {
+    parser p;
+    p.set_auto_help(false);
+    bool verbose = false;
+    i64 number = 42;
+    f64 rate = 0.5;
+    std::string file = "default.txt";
+    handle<bool> verbose_handle = p.add_parameter("v", "verbose", "Verbose mode", verbose);
+    p.add_parameter("n", "number", "A number", number);
+    p.add_parameter("r", "rate", "A rate", rate);
+    handle<std::string> file_handle = p.add_parameter("f", "file", "Input file", file);
+    
+    // Registration keeps the variables' values as defaults
+    ASSERT_EQ(42, number);
+    ASSERT_STREQ("default.txt", file);
+    ASSERT_TRUE(&p.get(file_handle) == &file);
+    
+    std::vector<std::string> args = {"program", "-v", "--number", "7", "-r", "2.5"};
+    ASSERT_TRUE(p.parse(args));
+    ASSERT_TRUE(verbose);
+    ASSERT_EQ(7, number);
+    ASSERT_EQ(2.5, rate);
+    ASSERT_STREQ("default.txt", file);
+    ASSERT_TRUE(p.get(verbose_handle));
+    
+    args = {"program", "--file", "test.txt"};
+    ASSERT_TRUE(p.parse(args));
+    ASSERT_STREQ("test.txt", file);
+    
+    // Name lookups read the bound variables too
+    std::string file_value;
+    ASSERT_TRUE(p.get_parameter_value_to("file", &file_value));
+    ASSERT_STREQ("test.txt", file_value);
+    number = 11;
+    i64 number_value = 0;
+    ASSERT_TRUE(p.get_parameter_value_to("n", &number_value));
+    ASSERT_EQ(11, number_value);
+    
+    return true;
+}
+
+// Test that defaults are converted only when they are needed
+bool test_lazy_defaults() {
+    parser p;
+    p.set_auto_help(false);
+    // neither an empty nor an invalid default is an error at registration
+    p.add_parameter<i64>("n", "number", "A number");
+    handle<i64> count = p.add_parameter<i64>("c", "count", "A count", false, "many");
+    handle<f64> rate = p.add_parameter<f64>("r", "rate", "A rate", false, "0.5");
+    handle<std::string> file = p.add_parameter<std::string>("f", "file", "Input file", false, "default.txt");
+    
+    // looking an option up before any parse converts only its default
+    i64 number_value = 1;
+    ASSERT_TRUE(p.get_parameter_value_to("number", &number_value));
+    ASSERT_EQ(0, number_value);
+    f64 rate_value = 0.0;
+    ASSERT_TRUE(p.get_parameter_value_to("rate", &rate_value));
+    ASSERT_EQ(0.5, rate_value);
+    ASSERT_EQ(0.5, p.get(rate));
+    
+    // a given option never needs its default
+    std::vector<std::string> args = {"program", "-c", "3", "-r", "1.5"};
+    ASSERT_TRUE(p.parse(args));
+    ASSERT_EQ(3, p.get(count));
+    ASSERT_EQ(1.5, p.get(rate));
+    ASSERT_STREQ("default.txt", p.get(file));
+    
+    args = {"program"};
+    ASSERT_TRUE(p.parse(args));
+    ASSERT_EQ(0, p.get(count));
+    ASSERT_EQ(0.5, p.get(rate));
+    
+    parse_result result;
+    ASSERT_TRUE(p.parse(args, result));
+    ASSERT_EQ(0.5, result.get(rate));
+    ASSERT_TRUE(result.get(file) == "default.txt");
+    
+    return true;
+}
+
+// Test that reading a handle before any parse or freeze gives the default
+bool test_get_before_parse() {
+    parser p;
+    p.set_auto_help(false);
+    handle<i64> count = p.add_parameter<i64>("c", "count", "A count", false, "42");
+    handle<std::string> file = p.add_parameter<std::string>("f", "file", "Input file", false, "default.txt");
+    ASSERT_EQ(42, p.get(count));
+    ASSERT_STREQ("default.txt", p.get(file));
+    i64 count_value = 0;
+    ASSERT_TRUE(p.get_parameter_value_to("count", &count_value));
+    ASSERT_EQ(42, count_value);
+    
+    // an option added after the first read is converted on the next one
+    handle<f64> rate = p.add_parameter<f64>("r", "rate", "A rate", false, "0.5");
+    ASSERT_EQ(0.5, p.get(rate));
+    ASSERT_EQ(42, p.get(count));
+    
+    return true;
+}
+
+// Test that deferred conversion converts values when they are read
+bool test_deferred_conversion() {
+    parser p;
+    p.set_auto_help(false);
+    p.set_deferred_conversion(true);
+    handle<i64> number = p.add_parameter<i64>("n", "number", "A number", false, "1");
+    handle<f64> rate = p.add_parameter<f64>("r", "rate", "A rate", false, "0.5");
+    handle<std::string> file = p.add_parameter<std::string>("f", "file", "Input file");
+    handle<bool> verbose = p.add_parameter<bool>("v", "verbose", "Verbose mode");
+    i64 bound = 0;
+    p.add_parameter("b", "bound", "A bound number", bound);
+    
+    // an invalid value does not fail the parse and reads as the default
+    std::vector<std::string> args = {"program", "-n", "12", "-r", "fast", "-f", "data.csv", "-v", "-b", "9"};
+    ASSERT_TRUE(p.parse(args));
+    ASSERT_EQ(9, bound);
+    ASSERT_EQ(12, p.get(number));
+    ASSERT_STREQ("data.csv", p.get(file));
+    ASSERT_TRUE(p.get(verbose));
+    ASSERT_EQ(0.5, p.get(rate));
+    
+    // nothing carries over to the next parse
+    args = {"program", "-r", "2.5"};
+    ASSERT_TRUE(p.parse(args));
+    ASSERT_EQ(1, p.get(number));
+    f64 rate_value = 0.0;
+    ASSERT_TRUE(p.get_parameter_value_to("rate", &rate_value));
+    ASSERT_EQ(2.5, rate_value);
+    ASSERT_FALSE(p.get(verbose));
+    
+    parse_result result;
+    args = {"program", "--number", "0x10", "--rate", "4"};
+    ASSERT_TRUE(p.parse(args, result));
+    ASSERT_TRUE(result.get_error().empty());
+    ASSERT_EQ(4.0, result.get(rate));
+    ASSERT_EQ(1, result.get(number));
+    ASSERT_TRUE(result.is_set(number));
+    ASSERT_STREQ("error: invalid value 0x10 for parameter number", result.get_error());
+    
+    return true;
+}
+
+// Test that freezing reports invalid defaults only when asked to
+bool test_freeze_validates_defaults() {
+    parser p;
+    p.set_auto_help(false);
+    p.add_parameter<i64>("n", "number", "A number", false, "12");
+    p.add_parameter<f64>("r", "", "A rate", false, "fast");
+    ASSERT_TRUE(p.freeze());
+    ASSERT_FALSE(p.freeze(true));
+    
+    parser valid;
+    valid.add_parameter<i64>("n", "number", "A number", false, "12");
+    valid.add_parameter<std::string>("f", "file", "Input file", false, "");
+    ASSERT_TRUE(valid.freeze(true));
+    i64 number = 0;
+    ASSERT_TRUE(valid.get_parameter_value_to("n", &number));
+    ASSERT_EQ(12, number);
+    
+    return true;
+}
+
 // Main test runner
 int main() {
     std::cout << "Running parser tests..." << std::endl;
@@ -259,10 +550,19 @@ int main() {
     RUN_TEST(test_parse_float_parameter);
     RUN_TEST(test_parse_multiple_parameters);
     RUN_TEST(test_parse_argc_argv);
+    RUN_TEST(test_parse_argc_argv_values);
+    RUN_TEST(test_parse_keeps_args);
     RUN_TEST(test_parse_unknown_parameter);
     RUN_TEST(test_parse_missing_value);
     RUN_TEST(test_help_message);
     RUN_TEST(test_get_nonexistent_parameter);
+    RUN_TEST(test_typed_handles);
+    RUN_TEST(test_typed_handles_with_untyped_lookup);
+    RUN_TEST(test_bound_variables);
+    RUN_TEST(test_lazy_defaults);
+    RUN_TEST(test_get_before_parse);
+    RUN_TEST(test_freeze_validates_defaults);
+    RUN_TEST(test_deferred_conversion);
     
     print_test_summary();
     
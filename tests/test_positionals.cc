@@ -0,0 +1,251 @@
+#include "allocation_counter.h"
+#include "argparse/parser.h"
+#include "argparse/response_files.h"
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+using namespace argparse;
+
+// Test fixed, optional and variadic positionals between options
+bool test_positional_kinds() {
+    parser p;
+    p.set_auto_help(false);
+    handle<bool> verbose = p.add_parameter<bool>("v", "verbose", "Verbose mode");
+    handle<std::string> command = p.add_positional<std::string>("command", "Command to run");
+    handle<i64> jobs = p.add_positional<i64>("jobs", "Parallel jobs", false, "4");
+    handle<std::vector<std::string_view>> files = p.add_variadic("files", "Input files");
+
+    const char* argv[] = {"tool", "build", "-v", "8", "a.txt", "b.txt", "c.txt"};
+    parse_result result;
+    ASSERT_TRUE(p.parse(7, argv, result));
+    ASSERT_TRUE(result.get(verbose));
+    ASSERT_TRUE(result.get(command) == "build");
+    ASSERT_EQ(8, result.get(jobs));
+    span<const std::string_view> paths = result.get(files);
+    ASSERT_EQ(3, (i64)paths.size());
+    ASSERT_TRUE(paths[0] == "a.txt");
+    ASSERT_TRUE(paths[2] == "c.txt");
+    // views into argv, not copies
+    ASSERT_TRUE(paths[1].data() == argv[5]);
+    ASSERT_TRUE(result.is_set(files));
+
+    // the optional positional keeps its default when only the required one is given
+    ASSERT_TRUE(p.parse(2, argv, result));
+    ASSERT_TRUE(result.get(command) == "build");
+    ASSERT_EQ(4, result.get(jobs));
+    ASSERT_FALSE(result.is_set(jobs));
+    ASSERT_TRUE(result.get(files).empty());
+    ASSERT_FALSE(result.is_set(files));
+
+    return true;
+}
+
+// Test the errors for missing, surplus and invalid positionals
+bool test_positional_errors() {
+    parser p;
+    p.set_auto_help(false);
+    p.add_parameter<bool>("v", "verbose", "Verbose mode");
+    p.add_positional<std::string>("source", "Source file");
+    p.add_positional<i64>("count", "Copies");
+    parse_result result;
+
+    const char* missing[] = {"tool", "a.txt", "-v"};
+    ASSERT_FALSE(p.parse(3, missing, result));
+    ASSERT_STREQ("error: missing argument count", result.get_error());
+
+    const char* surplus[] = {"tool", "a.txt", "2", "extra", "--bogus"};
+    ASSERT_FALSE(p.parse(5, surplus, result));
+    ASSERT_STREQ("error: unexpected argument extra", result.get_error());
+
+    const char* invalid[] = {"tool", "a.txt", "two"};
+    ASSERT_FALSE(p.parse(3, invalid, result));
+    ASSERT_STREQ("error: invalid value two for parameter count", result.get_error());
+
+    parser required;
+    required.set_auto_help(false);
+    required.add_variadic("files", "Input files", true);
+    const char* none[] = {"tool"};
+    ASSERT_FALSE(required.parse(1, none, result));
+    ASSERT_STREQ("error: missing argument files", result.get_error());
+    ASSERT_FALSE(required.add_variadic("more", "Second list").is_valid());
+
+    return true;
+}
+
+// Test that "--" makes the remaining tokens positionals
+bool test_positionals_after_terminator() {
+    parser p;
+    p.set_auto_help(false);
+    handle<bool> verbose = p.add_parameter<bool>("v", "verbose", "Verbose mode");
+    handle<std::vector<std::string_view>> files = p.add_variadic("files", "Input files");
+    const char* argv[] = {"tool", "a", "--", "-v", "--name=x", "--"};
+    parse_result result;
+    ASSERT_TRUE(p.parse(6, argv, result));
+    ASSERT_FALSE(result.get(verbose));
+    span<const std::string_view> paths = result.get(files);
+    ASSERT_EQ(4, (i64)paths.size());
+    ASSERT_TRUE(paths[1] == "-v");
+    ASSERT_TRUE(paths[3] == "--");
+
+    return true;
+}
+
+// Test the stateful parser, name lookups and the help text
+bool test_stateful_positionals() {
+    parser p;
+    p.set_auto_help(false);
+    p.add_parameter("n", "number", "A number", INTEGER, false, "1");
+    handle<std::string> output = p.add_positional<std::string>("output", "Output file", false, "out.txt");
+    handle<std::vector<std::string_view>> files = p.add_variadic("files", "Input files", true);
+
+    std::vector<std::string> args = {"/bin/tool", "result.txt", "-n", "3", "x", "y"};
+    ASSERT_TRUE(p.parse(args));
+    ASSERT_STREQ("result.txt", p.get(output));
+    ASSERT_EQ(2, (i64)p.get(files).size());
+    ASSERT_TRUE(p.get(files)[1] == "y");
+
+    std::string text;
+    ASSERT_TRUE(p.get_parameter_value_to("output", &text));
+    ASSERT_STREQ("result.txt", text);
+    std::vector<std::string_view> list;
+    ASSERT_TRUE(p.get_parameter_value_to("files", &list));
+    ASSERT_EQ(2, (i64)list.size());
+    ASSERT_FALSE(p.get_parameter_value_to("--files", &list));
+
+    // with only one token the required variadic takes it
+    ASSERT_TRUE(p.parse(std::vector<std::string>{"tool", "only"}));
+    ASSERT_STREQ("out.txt", p.get(output));
+    ASSERT_EQ(1, (i64)p.get(files).size());
+
+    std::string help = p.get_help_message();
+    ASSERT_TRUE(help.find("Usage: tool [options] [output] <files...>") != std::string::npos);
+    ASSERT_TRUE(help.find("\noutput\tOutput file") != std::string::npos);
+    ASSERT_TRUE(help.find("--output") == std::string::npos);
+
+    return true;
+}
+
+// Test positionals in a batch and with deferred conversion
+bool test_batch_and_deferred_positionals() {
+    parser p;
+    p.set_auto_help(false);
+    handle<i64> count = p.add_positional<i64>("count", "Copies");
+    p.add_variadic("files", "Input files");
+
+    const char* row0[] = {"tool", "3", "a"};
+    const char* row1[] = {"tool", "x"};
+    const char* row2[] = {"tool", "5"};
+    std::vector<arg_vector> inputs = {{3, row0}, {2, row1}, {2, row2}};
+    batch_result results;
+    ASSERT_FALSE(p.parse_batch(inputs, results, 1));
+    ASSERT_EQ(3, results.column(count)[0]);
+    ASSERT_FALSE(results.succeeded(1));
+    ASSERT_EQ(5, results.column(count)[2]);
+
+    p.set_deferred_conversion(true);
+    parse_result result;
+    ASSERT_TRUE(p.parse(2, row1, result));
+    ASSERT_EQ(0, result.get(count));
+    ASSERT_STREQ("error: invalid value x for parameter count", result.get_error());
+
+    return true;
+}
+
+// Test that tens of thousands of paths are parsed without allocating, from
+// argv and from a response file
+bool test_many_paths_without_allocation() {
+    parser p;
+    p.set_auto_help(false);
+    handle<bool> verbose = p.add_parameter<bool>("v", "verbose", "Verbose mode");
+    handle<std::vector<std::string_view>> files = p.add_variadic("files", "Input files");
+    p.freeze();
+
+    std::vector<std::string> paths;
+    std::string content;
+    for (int i = 0; i < 50000; i++) {
+        paths.push_back("/data/input/part-" + std::to_string(i) + ".csv");
+        content += paths.back() + "\n";
+    }
+    std::vector<const char*> argv = {"tool", "-v"};
+    for (const std::string& path : paths) {
+        argv.push_back(path.c_str());
+    }
+
+    parse_result result;
+    ASSERT_TRUE(p.parse((int)argv.size(), argv.data(), result));
+    ASSERT_NO_ALLOCATIONS(p.parse((int)argv.size(), argv.data(), result));
+    ASSERT_TRUE(result.get(verbose));
+    span<const std::string_view> parsed = result.get(files);
+    ASSERT_EQ(50000, (i64)parsed.size());
+    ASSERT_TRUE(parsed[49999] == paths[49999]);
+
+    std::string path = "/tmp/argparse_test_" + std::to_string(getpid()) + "_paths";
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << content;
+    }
+    std::string argument = "@" + path;
+    const char* expand[] = {"tool", argument.c_str()};
+    response_files tokens;
+    ASSERT_TRUE(tokens.expand(2, expand));
+    ASSERT_TRUE(p.parse(tokens.tokens(), result));
+    ASSERT_NO_ALLOCATIONS(p.parse(tokens.tokens(), result));
+    parsed = result.get(files);
+    ASSERT_EQ(50000, (i64)parsed.size());
+    // the values point into the mapped file
+    ASSERT_TRUE(parsed[7].data() == tokens.tokens()[8].data());
+    ASSERT_TRUE(parsed[7] == paths[7]);
+    std::remove(path.c_str());
+
+    return true;
+}
+
+// Test that the stateful parser's variadic values outlive the tokens of a
+// vector or argv, while those of a span stay views into it
+bool test_variadic_outlives_tokens() {
+    parser p;
+    p.set_auto_help(false);
+    handle<std::vector<std::string_view>> files = p.add_variadic("files", "Input files");
+
+    ASSERT_TRUE(p.parse(std::vector<std::string>{"tool", "a-path-longer-than-small-strings.txt", "b.txt"}));
+    ASSERT_EQ(2, (i64)p.get(files).size());
+    ASSERT_STREQ("a-path-longer-than-small-strings.txt", p.get(files)[0]);
+    ASSERT_STREQ("b.txt", p.get(files)[1]);
+
+    std::vector<std::string>* tokens = new std::vector<std::string>{"tool", "-", "/data/input/part-0.csv"};
+    std::vector<char*> argv;
+    for (std::string& token : *tokens) {
+        argv.push_back(&token[0]);
+    }
+    ASSERT_TRUE(p.parse((int)argv.size(), argv.data()));
+    delete tokens;
+    ASSERT_EQ(2, (i64)p.get(files).size());
+    ASSERT_STREQ("-", p.get(files)[0]);
+    ASSERT_STREQ("/data/input/part-0.csv", p.get(files)[1]);
+
+    std::vector<std::string_view> views = {"tool", "c.txt"};
+    ASSERT_TRUE(p.parse(span<const std::string_view>(views)));
+    ASSERT_TRUE(p.get(files)[0].data() == views[1].data());
+
+    return true;
+}
+
+// Main test runner
+int main() {
+    std::cout << "Running positional argument tests..." << std::endl;
+
+    RUN_TEST(test_positional_kinds);
+    RUN_TEST(test_positional_errors);
+    RUN_TEST(test_positionals_after_terminator);
+    RUN_TEST(test_stateful_positionals);
+    RUN_TEST(test_batch_and_deferred_positionals);
+    RUN_TEST(test_many_paths_without_allocation);
+    RUN_TEST(test_variadic_outlives_tokens);
+
+    print_test_summary();
+
+    return tests_failed > 0 ? 1 : 0;
+}
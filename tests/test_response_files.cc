@@ -0,0 +1,170 @@
+#include "test_framework.h"
+#include "argparse/parser.h"
+#include "argparse/response_files.h"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+using namespace argparse;
+
+// Write content to a file in the temporary directory and return its path
+static std::string write_file(const std::string& name, const std::string& content) {
+    std::string path = "/tmp/argparse_test_" + std::to_string(getpid()) + "_" + name;
+    std::ofstream out(path, std::ios::binary);
+    out << content;
+    return path;
+}
+
+static std::string read_file(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    std::stringstream content;
+    content << in.rdbuf();
+    return content.str();
+}
+
+static std::vector<std::string> strings(span<const std::string_view> tokens) {
+    std::vector<std::string> result;
+    for (std::string_view token : tokens) {
+        result.push_back(std::string(token));
+    }
+    return result;
+}
+
+// Test that @file arguments are replaced by the file's tokens, in order
+bool test_expand_in_order() {
+    std::string path = write_file("basic", "-n 5\n\t--file  input.txt\r\n  -v ");
+    std::string argument = "@" + path;
+    const char* argv[] = {"tool", "-x", argument.c_str(), "last"};
+    
+    response_files files;
+    ASSERT_TRUE(files.expand(4, argv));
+    std::vector<std::string> expected = {"tool", "-x", "-n", "5", "--file", "input.txt", "-v", "last"};
+    ASSERT_TRUE(expected == strings(files.tokens()));
+    
+    std::remove(path.c_str());
+    return true;
+}
+
+// Test quoting and escapes, and that the file itself is never modified
+bool test_quotes_and_escapes() {
+    std::string content = "'a b' \"c \\\"d\\\" \\\\e\" f\\ g '' x'y'z \"it's\" '@literal'";
+    std::string path = write_file("quotes", content);
+    
+    response_files files;
+    ASSERT_TRUE(files.expand(std::vector<std::string>{"tool", "@" + path}));
+    std::vector<std::string> expected = {"tool", "a b", "c \"d\" \\e", "f g", "", "xyz", "it's", "@literal"};
+    ASSERT_TRUE(expected == strings(files.tokens()));
+    ASSERT_STREQ(content, read_file(path));
+    
+    std::remove(path.c_str());
+    return true;
+}
+
+// Test nested files, including one file referenced twice
+bool test_nested_files() {
+    std::string inner = write_file("inner", "-v --rate 2.5");
+    std::string outer = write_file("outer", "-n 1 @" + inner + " -f x @" + inner);
+    
+    response_files files;
+    ASSERT_TRUE(files.expand(std::vector<std::string>{"tool", "@" + outer, "@"}));
+    std::vector<std::string> expected = {"tool", "-n", "1", "-v", "--rate", "2.5", "-f", "x", "-v", "--rate", "2.5", "@"};
+    ASSERT_TRUE(expected == strings(files.tokens()));
+    
+    std::remove(inner.c_str());
+    std::remove(outer.c_str());
+    return true;
+}
+
+// Test that a file including itself, directly or not, is an error
+bool test_cycles_detected() {
+    std::string a = "/tmp/argparse_test_" + std::to_string(getpid()) + "_a";
+    std::string b = write_file("b", "-v @" + a);
+    write_file("a", "-n 1 @" + b);
+    
+    response_files files;
+    ASSERT_FALSE(files.expand(std::vector<std::string>{"tool", "@" + a}));
+    ASSERT_STREQ("error: response file " + a + " includes itself", files.get_error());
+    
+    std::string self = write_file("self", "-v @/tmp/argparse_test_" + std::to_string(getpid()) + "_self");
+    ASSERT_FALSE(files.expand(std::vector<std::string>{"tool", "@" + self}));
+    ASSERT_STREQ("error: response file " + self + " includes itself", files.get_error());
+    
+    std::remove(a.c_str());
+    std::remove(b.c_str());
+    std::remove(self.c_str());
+    return true;
+}
+
+// Test errors for missing files and unterminated quotes, and empty files
+bool test_errors() {
+    response_files files;
+    ASSERT_FALSE(files.expand(std::vector<std::string>{"tool", "@/nonexistent/argparse/file"}));
+    ASSERT_STREQ("error: cannot open response file /nonexistent/argparse/file", files.get_error());
+    
+    std::string open_quote = write_file("open_quote", "-f 'unterminated");
+    ASSERT_FALSE(files.expand(std::vector<std::string>{"tool", "@" + open_quote}));
+    ASSERT_STREQ("error: unterminated quote in response file " + open_quote, files.get_error());
+    
+    std::string empty = write_file("empty", "");
+    ASSERT_TRUE(files.expand(std::vector<std::string>{"tool", "@" + empty, "-v"}));
+    ASSERT_EQ(2u, files.tokens().size());
+    ASSERT_STREQ("", files.get_error());
+    
+    std::remove(open_quote.c_str());
+    std::remove(empty.c_str());
+    return true;
+}
+
+// Test parsing the expanded tokens, statefully and into a result
+bool test_parse_expanded() {
+    parser p;
+    p.set_auto_help(false);
+    p.add_parameter("v", "verbose", "Verbose mode", NONE);
+    p.add_parameter("n", "number", "A number", INTEGER, false, "0");
+    handle<std::string> file = p.add_parameter<std::string>("f", "file", "Input file", false, "none");
+    
+    // many tokens, as written by tools that outgrow ARG_MAX
+    std::string content;
+    for (int i = 0; i < 100000; i++) {
+        content += "-f \"/data/input dir/part-" + std::to_string(i) + ".csv\"\n";
+    }
+    content += "--number 42 -v\n";
+    std::string path = write_file("many", content);
+    
+    response_files files;
+    ASSERT_TRUE(files.expand(std::vector<std::string>{"/usr/bin/tool", "@" + path}));
+    ASSERT_EQ(200004u, files.tokens().size());
+    
+    parse_result result;
+    ASSERT_TRUE(p.parse(files.tokens(), result));
+    ASSERT_STREQ("/data/input dir/part-99999.csv", result.get(file));
+    ASSERT_STREQ("tool", result.get_program_name());
+    
+    ASSERT_TRUE(p.parse(files.tokens()));
+    i64 number = 0;
+    p.get_parameter_value_to("number", &number);
+    ASSERT_EQ(42, number);
+    ASSERT_STREQ("/data/input dir/part-99999.csv", p.get(file));
+    
+    std::remove(path.c_str());
+    return true;
+}
+
+// Main test runner
+int main() {
+    std::cout << "Running response file tests..." << std::endl;
+    
+    RUN_TEST(test_expand_in_order);
+    RUN_TEST(test_quotes_and_escapes);
+    RUN_TEST(test_nested_files);
+    RUN_TEST(test_cycles_detected);
+    RUN_TEST(test_errors);
+    RUN_TEST(test_parse_expanded);
+    
+    print_test_summary();
+    
+    return tests_failed > 0 ? 1 : 0;
+}
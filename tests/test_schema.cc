@@ -0,0 +1,188 @@
+#include "test_framework.h"
+#include "argparse/schema.h"
+#include "argparse/parser.h"
+#include <string>
+
+using namespace argparse;
+
+struct tool_options {
+    bool verbose = false;
+    i64 count = 1;
+    f64 rate = 0.5;
+    std::string_view file = "input.txt";
+    u16 port = 8080;
+    i32 level = -1;
+};
+
+constexpr auto tool_schema = make_schema(
+    option("v", "verbose", "Enable verbose output", &tool_options::verbose),
+    option("n", "count", "Number of iterations", &tool_options::count),
+    option("r", "rate", "Sampling rate", &tool_options::rate),
+    option("f", "file", "Input file path", &tool_options::file),
+    option("", "port", "Port to listen on", &tool_options::port),
+    option("lvl", "", "Log level", &tool_options::level));
+
+// lookups and help text are resolved by the compiler
+static_assert(tool_schema.find_short("v") == 0, "short name lookup");
+static_assert(tool_schema.find_long("port") == 4, "long name lookup");
+static_assert(tool_schema.find_short("lvl") == 5, "multi-character short name lookup");
+static_assert(tool_schema.find_long("verbos") == -1, "unknown long name");
+static_assert(tool_schema.find_short("port") == -1, "long names are not short names");
+static_assert(tool_schema.find_long("") == -1, "empty name");
+
+constexpr auto tool_help = tool_schema.help_text<tool_schema.help_length()>();
+
+// Test parsing into the values struct
+bool test_schema_parse() {
+    const char* argv[] = {"tool", "-v", "--count", "12", "-r", "2.5", "--file", "data.csv", "--port", "443", "-lvl", "-3"};
+    tool_options values;
+    std::string error;
+    ASSERT_TRUE(tool_schema.parse(12, argv, values, &error));
+    ASSERT_TRUE(values.verbose);
+    ASSERT_EQ(12, values.count);
+    ASSERT_EQ(2.5, values.rate);
+    ASSERT_TRUE(values.file == "data.csv");
+    ASSERT_EQ(443, values.port);
+    // like the runtime parser, a numeric option takes a negative number
+    ASSERT_EQ(-3, values.level);
+    
+    return true;
+}
+
+// Test the GNU forms the runtime parser accepts
+bool test_schema_gnu_forms() {
+    const char* argv[] = {"tool", "--count=7", "-vfdata.csv", "-n-2", "--rate", "-.5", "--"};
+    tool_options values;
+    std::string error;
+    ASSERT_TRUE(tool_schema.parse(7, argv, values, &error));
+    ASSERT_TRUE(values.verbose);
+    ASSERT_EQ(-2, values.count);
+    ASSERT_TRUE(values.file == "data.csv");
+    ASSERT_EQ(-0.5, values.rate);
+    
+    const char* flag_value[] = {"tool", "--verbose=yes"};
+    ASSERT_FALSE(tool_schema.parse(2, flag_value, values, &error));
+    ASSERT_STREQ("error: parameter verbose does not take a value", error);
+    
+    const char* text_dash[] = {"tool", "-f", "-v"};
+    ASSERT_FALSE(tool_schema.parse(3, text_dash, values, &error));
+    ASSERT_STREQ("error: parameter f requires a value", error);
+    
+    const char* after_end[] = {"tool", "--", "-v"};
+    ASSERT_FALSE(tool_schema.parse(3, after_end, values, &error));
+    ASSERT_STREQ("error: unexpected argument -v", error);
+    
+    return true;
+}
+
+// Test that options not given keep the struct's defaults
+bool test_schema_defaults() {
+    const char* argv[] = {"tool", "-lvl", "4"};
+    tool_options values;
+    ASSERT_TRUE(tool_schema.parse(3, argv, values));
+    ASSERT_FALSE(values.verbose);
+    ASSERT_EQ(1, values.count);
+    ASSERT_TRUE(values.file == "input.txt");
+    ASSERT_EQ(4, values.level);
+    
+    ASSERT_TRUE(tool_schema.parse(1, argv, values));
+    ASSERT_TRUE(tool_schema.parse(0, nullptr, values));
+    
+    return true;
+}
+
+// Test the error messages
+bool test_schema_errors() {
+    tool_options values;
+    std::string error;
+    
+    const char* unknown[] = {"tool", "--colour"};
+    ASSERT_FALSE(tool_schema.parse(2, unknown, values, &error));
+    ASSERT_STREQ("error: unknown parameter colour", error);
+    
+    const char* missing[] = {"tool", "-n"};
+    ASSERT_FALSE(tool_schema.parse(2, missing, values, &error));
+    ASSERT_STREQ("error: parameter n requires a value", error);
+    
+    const char* invalid[] = {"tool", "--port", "70000"};
+    ASSERT_FALSE(tool_schema.parse(3, invalid, values, &error));
+    ASSERT_STREQ("error: invalid value 70000 for parameter port", error);
+    
+    const char* stray[] = {"tool", "file.txt"};
+    ASSERT_FALSE(tool_schema.parse(2, stray, values));
+    
+    return true;
+}
+
+// Test that a long invalid value is quoted as the runtime parser quotes it
+bool test_schema_long_value_error() {
+    std::string value(1000, '9');
+    const char* argv[] = {"tool", "-n", value.c_str()};
+    tool_options values;
+    std::string error;
+    ASSERT_FALSE(tool_schema.parse(3, argv, values, &error));
+    ASSERT_STREQ("error: invalid value " + std::string(80, '9') + "... for parameter n", error);
+    
+    parser p;
+    p.set_auto_help(false);
+    p.add_parameter<i64>("n", "count", "Number of iterations", false, "1");
+    parse_result result;
+    ASSERT_FALSE(p.parse(3, argv, result));
+    ASSERT_STREQ(error, result.get_error());
+    
+    return true;
+}
+
+// Test the compile-time help text
+bool test_schema_help() {
+    std::string expected =
+        "--port\tPort to listen on\n"
+        "-f, --file\tInput file path\n"
+        "-lvl, \tLog level\n"
+        "-n, --count\tNumber of iterations\n"
+        "-r, --rate\tSampling rate\n"
+        "-v, --verbose\tEnable verbose output";
+    ASSERT_STREQ(expected, tool_help.data());
+    ASSERT_EQ(expected.size(), tool_schema.help_length());
+    
+    return true;
+}
+
+// Test a larger perfect table
+bool test_perfect_table() {
+    constexpr std::array<std::string_view, 40> keys = {
+        "alpha", "beta", "gamma", "delta", "epsilon", "zeta", "eta", "theta", "iota", "kappa",
+        "lambda", "mu", "nu", "xi", "omicron", "pi", "rho", "sigma", "tau", "upsilon",
+        "phi", "chi", "psi", "omega", "a", "b", "c", "d", "e", "f",
+        "include", "define", "output", "optimize", "warnings", "", "std", "verbose", "quiet", "jobs"};
+    constexpr perfect_table<40> table(keys);
+    static_assert(table.find("optimize") == 33, "compile-time lookup");
+    
+    for (u64 i = 0; i < keys.size(); i++) {
+        if (!keys[i].empty()) {
+            ASSERT_EQ((i32)i, table.find(keys[i]));
+        }
+    }
+    ASSERT_EQ(-1, table.find(""));
+    ASSERT_EQ(-1, table.find("alph"));
+    ASSERT_EQ(-1, table.find("jobs2"));
+    
+    return true;
+}
+
+// Main test runner
+int main() {
+    std::cout << "Running schema tests..." << std::endl;
+    
+    RUN_TEST(test_schema_parse);
+    RUN_TEST(test_schema_gnu_forms);
+    RUN_TEST(test_schema_defaults);
+    RUN_TEST(test_schema_errors);
+    RUN_TEST(test_schema_long_value_error);
+    RUN_TEST(test_schema_help);
+    RUN_TEST(test_perfect_table);
+    
+    print_test_summary();
+    
+    return tests_failed > 0 ? 1 : 0;
+}
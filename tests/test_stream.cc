@@ -0,0 +1,257 @@
+#include "allocation_counter.h"
+#include "test_fixtures.h"
+#include <functional>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+using namespace argparse;
+
+// Test NUL separated options and positionals from a stream
+bool test_nul_separated_stream() {
+    parser p;
+    add_test_options(p);
+    std::istringstream in(join({"-v", "./a file with spaces", "--number", "7", "./b\nnewline", "-o", "result.csv"}, '\0'));
+    
+    std::vector<std::string> paths;
+    ASSERT_TRUE(p.parse_stream(in, '\0', [&](std::string_view path) { paths.push_back(std::string(path)); }));
+    ASSERT_EQ(2u, paths.size());
+    ASSERT_STREQ("./a file with spaces", paths[0]);
+    ASSERT_STREQ("./b\nnewline", paths[1]);
+    
+    bool verbose = false;
+    p.get_parameter_value_to("verbose", &verbose);
+    ASSERT_TRUE(verbose);
+    i64 number = 0;
+    p.get_parameter_value_to("n", &number);
+    ASSERT_EQ(7, number);
+    // the value outlives the stream's buffer
+    std::string output;
+    p.get_parameter_value_to("output", &output);
+    ASSERT_STREQ("result.csv", output);
+    
+    return true;
+}
+
+// Test newline separated tokens from a file descriptor, without a final newline
+bool test_newline_separated_fd() {
+    parser p;
+    add_test_options(p);
+    int fds[2];
+    ASSERT_EQ(0, pipe(fds));
+    std::string text = "--output\nlist.txt\nfirst\n-n\n3\nlast";
+    ASSERT_EQ((long)text.size(), (long)write(fds[1], text.data(), text.size()));
+    close(fds[1]);
+    
+    std::vector<std::string> paths;
+    bool parsed = p.parse_stream(fds[0], '\n', [&](std::string_view path) { paths.push_back(std::string(path)); });
+    close(fds[0]);
+    ASSERT_TRUE(parsed);
+    ASSERT_EQ(2u, paths.size());
+    ASSERT_STREQ("first", paths[0]);
+    ASSERT_STREQ("last", paths[1]);
+    
+    i64 number = 0;
+    p.get_parameter_value_to("number", &number);
+    ASSERT_EQ(3, number);
+    std::string output;
+    p.get_parameter_value_to("o", &output);
+    ASSERT_STREQ("list.txt", output);
+    
+    return true;
+}
+
+// Test tokens split across and longer than the chunks they are read in
+bool test_small_chunks() {
+    std::vector<std::string> tokens = {"", "a", "bb", "a-token-longer-than-one-chunk", "", "ccc", std::string(1000, 'x'), "end"};
+    std::istringstream in(join(tokens, '\0'));
+    token_stream stream(in, '\0', 4);
+    
+    std::vector<std::string> read;
+    std::string_view token;
+    while (stream.next(token)) {
+        read.push_back(std::string(token));
+    }
+    ASSERT_FALSE(stream.failed());
+    ASSERT_TRUE(tokens == read);
+    
+    parser p;
+    add_test_options(p);
+    std::istringstream options(join({"--output", "a-value-split-over-chunks.txt", "--number", "123456"}, '\0'));
+    token_stream option_stream(options, '\0', 5);
+    ASSERT_TRUE(p.parse_stream(option_stream));
+    std::string output;
+    p.get_parameter_value_to("output", &output);
+    ASSERT_STREQ("a-value-split-over-chunks.txt", output);
+    i64 number = 0;
+    p.get_parameter_value_to("number", &number);
+    ASSERT_EQ(123456, number);
+    
+    return true;
+}
+
+// Test errors, worded as for parse
+bool test_stream_errors() {
+    parser p;
+    add_test_options(p);
+    
+    std::istringstream positional("-v\nstray\n");
+    ASSERT_FALSE(p.parse_stream(positional, '\n'));
+    
+    std::istringstream missing("-v\n-n\n");
+    ASSERT_FALSE(p.parse_stream(missing, '\n'));
+    
+    std::istringstream unknown("--nothere\n");
+    ASSERT_FALSE(p.parse_stream(unknown, '\n'));
+    
+    std::istringstream invalid("-n\nseven\n");
+    ASSERT_FALSE(p.parse_stream(invalid, '\n'));
+    
+    // a later parse starts from the defaults again
+    std::istringstream empty("");
+    ASSERT_TRUE(p.parse_stream(empty, '\n'));
+    i64 number = 0;
+    p.get_parameter_value_to("number", &number);
+    ASSERT_EQ(1, number);
+    bool verbose = true;
+    p.get_parameter_value_to("v", &verbose);
+    ASSERT_FALSE(verbose);
+    
+    return true;
+}
+
+// Test deferred conversion of streamed values
+bool test_stream_deferred() {
+    parser p;
+    add_test_options(p);
+    p.set_deferred_conversion(true);
+    handle<i64> number = p.add_parameter<i64>("c", "count", "A count", false, "0");
+    std::istringstream in(join({"--count", "99", "-o", "deferred.txt"}, '\0'));
+    token_stream stream(in, '\0', 3);
+    ASSERT_TRUE(p.parse_stream(stream));
+    ASSERT_EQ(99, p.get(number));
+    std::string output;
+    p.get_parameter_value_to("output", &output);
+    ASSERT_STREQ("deferred.txt", output);
+    
+    return true;
+}
+
+// Test that memory does not grow with the length of the stream
+bool test_stream_memory_bounded() {
+    parser p;
+    add_test_options(p);
+    std::string text;
+    for (int i = 0; i < 200000; i++) {
+        text += "/data/input/part-" + std::to_string(i) + ".csv";
+        text += '\0';
+        if (i % 1000 == 0) {
+            text += "--output";
+            text += '\0';
+            text += "/results/" + std::to_string(i) + ".csv";
+            text += '\0';
+        }
+    }
+    
+    long long count = 0;
+    std::function<void(std::string_view)> positional = [&](std::string_view) { count++; };
+    std::istringstream first(text);
+    token_stream first_stream(first, '\0');
+    ASSERT_TRUE(p.parse_stream(first_stream, positional));
+    ASSERT_EQ(200000, count);
+    
+    std::istringstream second(text);
+    token_stream second_stream(second, '\0');
+    bool parsed = false;
+    ASSERT_NO_ALLOCATIONS(parsed = p.parse_stream(second_stream, positional));
+    ASSERT_TRUE(parsed);
+    ASSERT_EQ(400000, count);
+    std::string output;
+    p.get_parameter_value_to("output", &output);
+    ASSERT_STREQ("/results/199000.csv", output);
+    
+    return true;
+}
+
+// Test declared positionals fed from a stream without a callback
+bool test_stream_positionals() {
+    parser p;
+    test_options o = add_test_options(p);
+    handle<std::string> command = p.add_positional<std::string>("command", "Command to run");
+    handle<std::vector<std::string_view>> files = p.add_variadic("files", "Input files");
+    std::istringstream in(join({"-v", "build", "-n", "3", "a.c", "--", "-b.c"}, '\0'));
+    token_stream stream(in, '\0', 3);
+    ASSERT_TRUE(p.parse_stream(stream));
+    ASSERT_TRUE(p.get(o.verbose));
+    ASSERT_EQ(3, p.get(o.number));
+    ASSERT_STREQ("build", p.get(command));
+    ASSERT_EQ(2, (i64)p.get(files).size());
+    ASSERT_STREQ("a.c", p.get(files)[0]);
+    ASSERT_STREQ("-b.c", p.get(files)[1]);
+    
+    std::istringstream missing("-v\n");
+    ASSERT_FALSE(p.parse_stream(missing, '\n'));
+    
+    // with a callback the positionals take nothing, and none is missing
+    std::istringstream called("-v\nfirst\n");
+    u64 count = 0;
+    ASSERT_TRUE(p.parse_stream(called, '\n', [&](std::string_view) { count++; }));
+    ASSERT_EQ(1u, count);
+    
+    parser single;
+    single.set_auto_help(false);
+    single.add_positional<std::string>("command", "Command to run");
+    std::istringstream extra("build\nstray\n");
+    ASSERT_FALSE(single.parse_stream(extra, '\n'));
+    
+    return true;
+}
+
+// Test that list values share one buffer, reused by the next stream
+bool test_stream_lists_reuse_memory() {
+    parser p;
+    add_test_options(p);
+    handle<std::vector<std::string_view>> includes = p.add_parameter<std::vector<std::string_view>>("I", "include", "Include directory");
+    std::string text;
+    for (int i = 0; i < 10000; i++) {
+        text += "-I";
+        text += '\0';
+        text += "/usr/include/part-" + std::to_string(i);
+        text += '\0';
+    }
+    
+    std::istringstream first(text);
+    token_stream first_stream(first, '\0', 64);
+    ASSERT_TRUE(p.parse_stream(first_stream));
+    ASSERT_EQ(10000, (i64)p.get(includes).size());
+    
+    std::istringstream second(text);
+    token_stream second_stream(second, '\0', 64);
+    bool parsed = false;
+    ASSERT_NO_ALLOCATIONS(parsed = p.parse_stream(second_stream));
+    ASSERT_TRUE(parsed);
+    ASSERT_EQ(10000, (i64)p.get(includes).size());
+    ASSERT_STREQ("/usr/include/part-0", p.get(includes)[0]);
+    ASSERT_STREQ("/usr/include/part-9999", p.get(includes)[9999]);
+    
+    return true;
+}
+
+// Main test runner
+int main() {
+    std::cout << "Running stream tests..." << std::endl;
+    
+    RUN_TEST(test_nul_separated_stream);
+    RUN_TEST(test_newline_separated_fd);
+    RUN_TEST(test_small_chunks);
+    RUN_TEST(test_stream_errors);
+    RUN_TEST(test_stream_deferred);
+    RUN_TEST(test_stream_memory_bounded);
+    RUN_TEST(test_stream_positionals);
+    RUN_TEST(test_stream_lists_reuse_memory);
+    
+    print_test_summary();
+    
+    return tests_failed > 0 ? 1 : 0;
+}
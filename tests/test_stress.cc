@@ -0,0 +1,153 @@
+#include "allocation_counter.h"
+#include "test_fixtures.h"
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace argparse;
+
+static const u64 SMALL_COUNT = 1 << 16;
+static const u64 LARGE_COUNT = 1 << 20;
+
+// Stream buffer counting the bytes it hands out and the reads asking for them
+class counting_buffer : public std::stringbuf {
+public:
+    explicit counting_buffer(const std::string& text) : std::stringbuf(text), bytes(0), reads(0) {}
+    
+    long long bytes;
+    long long reads;
+    
+protected:
+    std::streamsize xsgetn(char* target, std::streamsize count) override {
+        std::streamsize read = std::stringbuf::xsgetn(target, count);
+        bytes += read;
+        reads++;
+        return read;
+    }
+};
+
+// Test that the memory a first parse needs does not grow with the tokens,
+// comparing the allocations for a number of tokens and eight times as many
+bool test_memory_constant_in_tokens() {
+    long long allocations[2];
+    u64 counts[2] = {SMALL_COUNT, 8 * SMALL_COUNT};
+    for (int i = 0; i < 2; i++) {
+        std::vector<std::string> tokens = make_tokens(counts[i]);
+        std::vector<const char*> argv = pointers(tokens);
+        parser p;
+        add_test_options(p);
+        p.freeze();
+        parse_result result;
+        long long before = allocation_count();
+        bool parsed = p.parse((int)argv.size(), argv.data(), result) && p.parse(tokens);
+        allocations[i] = allocation_count() - before;
+        ASSERT_TRUE(parsed);
+    }
+    ASSERT_EQ(allocations[0], allocations[1]);
+    
+    return true;
+}
+
+// Test that a stream is read once, in reads of nearly a whole chunk, so the
+// work grows in proportion to its size
+bool test_stream_reads_linear_in_size() {
+    const u64 chunk = 4096;
+    long long allocations[2];
+    u64 counts[2] = {SMALL_COUNT, 8 * SMALL_COUNT};
+    for (int i = 0; i < 2; i++) {
+        std::string text = join(make_tokens(counts[i]), '\0');
+        counting_buffer buffer(text);
+        std::istream in(&buffer);
+        token_stream tokens(in, '\0', chunk);
+        parser p;
+        add_test_options(p);
+        p.freeze();
+        long long positionals = 0;
+        long long before = allocation_count();
+        bool parsed = p.parse_stream(tokens, [&](std::string_view) { positionals++; });
+        allocations[i] = allocation_count() - before;
+        ASSERT_TRUE(parsed);
+        // only the program name is not an option or its value
+        ASSERT_EQ(1, positionals);
+        ASSERT_EQ((long long)text.size(), buffer.bytes);
+        // a read fills the chunk but for the part of a token kept from the
+        // last one, which is shorter than 64 bytes here
+        ASSERT_TRUE(buffer.reads <= (long long)(text.size() / (chunk - 64) + 2));
+    }
+    ASSERT_EQ(allocations[0], allocations[1]);
+    
+    return true;
+}
+
+// Test that a million tokens are parsed without any extra memory
+bool test_many_tokens_do_not_allocate() {
+    parser p;
+    add_test_options(p);
+    p.freeze();
+    std::vector<std::string> tokens = make_tokens(LARGE_COUNT);
+    std::vector<const char*> argv = pointers(tokens);
+    
+    parse_result result;
+    ASSERT_TRUE(p.parse((int)argv.size(), argv.data(), result));
+    bool ok = false;
+    ASSERT_NO_ALLOCATIONS(ok = p.parse((int)argv.size(), argv.data(), result));
+    ASSERT_TRUE(ok);
+    ASSERT_TRUE(p.parse(tokens));
+    ASSERT_NO_ALLOCATIONS(ok = p.parse(tokens));
+    ASSERT_TRUE(ok);
+    
+    // the last occurrence wins
+    u64 last = tokens.size() - 1;
+    while (tokens[last - 1] != "-f") {
+        last--;
+    }
+    std::string file;
+    p.get_parameter_value_to("file", &file);
+    ASSERT_STREQ(tokens[last], file);
+    
+    return true;
+}
+
+// Test that huge values are converted and copied correctly
+bool test_huge_values() {
+    parser p;
+    add_test_options(p);
+    p.freeze();
+    std::string number = std::string(8 << 20, '0') + "42";
+    std::string rate = "1." + std::string(8 << 20, '0') + "1";
+    std::string file(32 << 20, 'x');
+    std::vector<std::string> args = {"tool", "-n", number, "--rate", rate, "--file", file};
+    ASSERT_TRUE(p.parse(args));
+    
+    i64 n = 0;
+    p.get_parameter_value_to("n", &n);
+    ASSERT_EQ(42, n);
+    f64 r = 0.0;
+    p.get_parameter_value_to("rate", &r);
+    ASSERT_EQ(1.0, r);
+    std::string text;
+    p.get_parameter_value_to("file", &text);
+    ASSERT_EQ(file.size(), text.size());
+    
+    // a huge invalid value is rejected, and quoted only in part
+    args[2] = std::string(8 << 20, '9');
+    parse_result result;
+    ASSERT_FALSE(p.parse(args, result));
+    ASSERT_STREQ("error: invalid value " + std::string(80, '9') + "... for parameter n", result.get_error());
+    
+    return true;
+}
+
+// Main test runner
+int main() {
+    std::cout << "Running stress tests..." << std::endl;
+    
+    RUN_TEST(test_memory_constant_in_tokens);
+    RUN_TEST(test_stream_reads_linear_in_size);
+    RUN_TEST(test_many_tokens_do_not_allocate);
+    RUN_TEST(test_huge_values);
+    
+    print_test_summary();
+    
+    return tests_failed > 0 ? 1 : 0;
+}
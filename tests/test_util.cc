@@ -143,6 +143,22 @@ bool test_util_parameter_required() {
     return true;
 }
 
+bool test_util_append_value() {
+    std::string message = "error: invalid value ";
+    util::append_value(message, "short");
+    ASSERT_STREQ("error: invalid value short", message);
+    
+    // a value of exactly 80 bytes is kept whole, a longer one is cut
+    message.clear();
+    util::append_value(message, std::string(80, 'x'));
+    ASSERT_STREQ(std::string(80, 'x'), message);
+    message.clear();
+    util::append_value(message, std::string(81, 'x'));
+    ASSERT_STREQ(std::string(80, 'x') + "...", message);
+    
+    return true;
+}
+
 // Main test runner
 int main() {
     std::cout << "Running util tests..." << std::endl;
@@ -155,6 +171,7 @@ int main() {
     RUN_TEST(test_util_create_parameter_empty_names);
     RUN_TEST(test_util_parameter_functionality);
     RUN_TEST(test_util_parameter_required);
+    RUN_TEST(test_util_append_value);
     
     print_test_summary();
     